@@ -4,76 +4,32 @@
 #include "Ammo.h"
 #include "Components/BoxComponent.h"
 #include "Components/WidgetComponent.h"
-#include "Components/SphereComponent.h"
+#include "ZombieTeamProject.h"
 
 AAmmo::AAmmo()
 {
+	LLM_SCOPE_BYTAG(ZombieItems);
+
 	AmmoMesh = CreateAbstractDefaultSubobject<UStaticMeshComponent>(TEXT("AmmoMesh"));
 	SetRootComponent(AmmoMesh);
 
 	GetCollisionBox()->SetupAttachment(GetRootComponent());
 	GetPickupWidget()->SetupAttachment(GetRootComponent());
-	GetAreaSphere()->SetupAttachment(GetRootComponent());
 }
 
-void AAmmo::Tick(float DeltaTime)
+void AAmmo::BeginPlay()
 {
-	Super::Tick(DeltaTime);
+	Super::BeginPlay();
 }
 
-void AAmmo::BeginPlay()
+UPrimitiveComponent* AAmmo::GetPhysicsComponent() const
 {
-	Super::BeginPlay();
+	return AmmoMesh;
 }
 
 void AAmmo::SetItemProperties(EItemState State)
 {
 	Super::SetItemProperties(State);
 
-	switch (State)
-	{
-	case EItemState::EIS_Pickup:
-		//Set AmmoMesh properties
-		AmmoMesh->SetSimulatePhysics(false);
-		AmmoMesh->SetEnableGravity(false);
-		AmmoMesh->SetVisibility(true);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		
-		break;
-
-	case EItemState::EIS_Equipped:
-		//Set AmmoMesh properties
-		AmmoMesh->SetSimulatePhysics(false);
-		AmmoMesh->SetEnableGravity(false);
-		AmmoMesh->SetVisibility(true);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		
-		break;
-
-	case EItemState::EIS_Falling:
-		AmmoMesh->SetSimulatePhysics(true);
-		AmmoMesh->SetEnableGravity(true);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic,
-			ECollisionResponse::ECR_Block);
-
-		
-		break;
-
-	case EItemState::EIS_EquipInterping:
-		//Set ItemMesh properties
-		AmmoMesh->SetSimulatePhysics(false);
-		AmmoMesh->SetEnableGravity(false);
-		AmmoMesh->SetVisibility(true);
-		AmmoMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AmmoMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		
-		break;
-	}
+	ApplyComponentProfile(AmmoMesh, State, EItemComponent::EIC_AuxMesh);
 }
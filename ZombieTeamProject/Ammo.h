@@ -18,13 +18,14 @@ class ZOMBIETEAMPROJECT_API AAmmo : public AItem
 public:
 	AAmmo();
 
-	virtual void Tick(float DeltaTime) override;
-
 protected:
 	virtual void BeginPlay() override;
 
 	virtual void SetItemProperties(EItemState State) override;
 
+	/** Ammo falls on its own mesh, not the item mesh */
+	virtual UPrimitiveComponent* GetPhysicsComponent() const override;
+
 private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Ammo, meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* AmmoMesh;
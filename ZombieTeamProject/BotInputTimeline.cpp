@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BotInputTimeline.h"
+#include "Misc/FileHelper.h"
+
+bool UBotInputTimeline::LoadEventsFromCsv(const FString& FilePath, TArray<FBotInputEvent>& OutEvents)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+	{
+		return false;
+	}
+
+	const UEnum* InputEnum{ StaticEnum<EBotInput>() };
+
+	for (const FString& Line : Lines)
+	{
+		const FString Trimmed{ Line.TrimStartAndEnd() };
+		if (Trimmed.IsEmpty() || Trimmed.StartsWith(TEXT("#"))) continue;
+
+		TArray<FString> Fields;
+		Trimmed.ParseIntoArray(Fields, TEXT(","));
+		if (Fields.Num() < 3 || !Fields[0].IsNumeric()) continue;
+
+		const int64 InputValue{ InputEnum->GetValueByNameString(Fields[1].TrimStartAndEnd()) };
+		if (InputValue == INDEX_NONE || InputValue >= static_cast<int64>(EBotInput::EBI_MAX)) continue;
+
+		FBotInputEvent& Event = OutEvents.AddDefaulted_GetRef();
+		Event.Time = FCString::Atof(*Fields[0]);
+		Event.Input = static_cast<EBotInput>(InputValue);
+		Event.Value = FCString::Atof(*Fields[2].TrimStartAndEnd());
+	}
+
+	OutEvents.StableSort([](const FBotInputEvent& A, const FBotInputEvent& B)
+	{
+		return A.Time < B.Time;
+	});
+
+	return true;
+}
+
+bool UBotInputTimeline::SaveEventsToCsv(const FString& FilePath, const TArray<FBotInputEvent>& Events)
+{
+	const UEnum* InputEnum{ StaticEnum<EBotInput>() };
+
+	FString Csv{ TEXT("# Time,Input,Value\n") };
+	for (const FBotInputEvent& Event : Events)
+	{
+		Csv += FString::Printf(TEXT("%.4f,%s,%g\n"),
+			Event.Time,
+			*InputEnum->GetNameStringByValue(static_cast<int64>(Event.Input)),
+			Event.Value);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *FilePath);
+}
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "BotInputTimeline.generated.h"
+
+UENUM(BlueprintType)
+enum class EBotInput : uint8
+{
+	EBI_MoveForward UMETA(DisplayName = "MoveForward"),
+	EBI_MoveRight UMETA(DisplayName = "MoveRight"),
+	EBI_Turn UMETA(DisplayName = "Turn"),
+	EBI_LookUp UMETA(DisplayName = "LookUp"),
+	EBI_Fire UMETA(DisplayName = "Fire"),
+	EBI_Aim UMETA(DisplayName = "Aim"),
+	EBI_Interact UMETA(DisplayName = "Interact"),
+	EBI_Reload UMETA(DisplayName = "Reload"),
+	EBI_SelectSlot UMETA(DisplayName = "SelectSlot"),
+
+	EBI_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/**
+ * One input change at a point on the timeline. Axis inputs hold Value until the
+ * next event for the same axis, buttons are pressed while Value is non-zero and
+ * SelectSlot uses Value as the slot index.
+ */
+USTRUCT(BlueprintType)
+struct FBotInputEvent
+{
+	GENERATED_BODY()
+
+	/** Seconds from the start of the timeline */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Time{ 0.f };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EBotInput Input{ EBotInput::EBI_MoveForward };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Value{ 0.f };
+};
+
+/**
+ * Input timeline replayed by ABotPlayerController
+ */
+UCLASS(BlueprintType)
+class ZOMBIETEAMPROJECT_API UBotInputTimeline : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Events sorted by time */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Timeline)
+	TArray<FBotInputEvent> Events;
+
+	/** Restart from the first event once Length has passed */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Timeline)
+	bool bLoop{ true };
+
+	/** Length of one pass; the last event's time is used when zero */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Timeline)
+	float Length{ 0.f };
+
+	/**
+	 * Read "Time,Input,Value" lines, e.g. "1.5,EBI_Fire,1". Blank lines and
+	 * lines starting with # are skipped. Returns false if the file can't be read.
+	 */
+	static bool LoadEventsFromCsv(const FString& FilePath, TArray<FBotInputEvent>& OutEvents);
+
+	/** Write events in the format LoadEventsFromCsv reads. Returns false if the file can't be written. */
+	static bool SaveEventsToCsv(const FString& FilePath, const TArray<FBotInputEvent>& Events);
+};
@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BotPlayerController.h"
+#include "MainCharacter.h"
+#include "InventoryComponent.h"
+#include "ZombieTeamProjectGameMode.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "GameFramework/PlayerState.h"
+
+ABotPlayerController::ABotPlayerController() :
+	Seed(1337),
+	ScriptedLength(60.f),
+	bLoop(true),
+	LoopLength(0.f),
+	TimelineTime(0.f),
+	NextEvent(0),
+	ForwardAxis(0.f),
+	RightAxis(0.f),
+	TurnAxis(0.f),
+	LookUpAxis(0.f),
+	bFireHeld(false),
+	bAimHeld(false),
+	bInteractHeld(false)
+{
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void ABotPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// An explicit -BotSeed= keeps the bot's script fixed while the gameplay seed varies
+	if (FParse::Value(FCommandLine::Get(), TEXT("BotSeed="), Seed))
+	{
+		RandomStream.Initialize(Seed);
+	}
+	else
+	{
+		// Every bot draws its own seed, so several bots in one session run different scripts
+		FRandomStream& BotStream = AZombieTeamProjectGameMode::GetRandomStream(this, EGameplayRandomStream::EGRS_Bot);
+		const int32 PlayerId{ PlayerState ? PlayerState->GetPlayerId() : 0 };
+		RandomStream.Initialize(static_cast<int32>(HashCombine(static_cast<uint32>(BotStream.RandHelper(MAX_int32)), static_cast<uint32>(PlayerId))));
+	}
+
+	FString TimelinePath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("BotTimeline="), TimelinePath))
+	{
+		if (FPaths::IsRelative(TimelinePath))
+		{
+			TimelinePath = FPaths::Combine(FPaths::ProjectDir(), TimelinePath);
+		}
+
+		if (!UBotInputTimeline::LoadEventsFromCsv(TimelinePath, Events))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Bot timeline %s could not be read"), *TimelinePath);
+		}
+	}
+	else if (Timeline)
+	{
+		Events = Timeline->Events;
+		bLoop = Timeline->bLoop;
+		LoopLength = Timeline->Length;
+	}
+
+	if (Events.Num() == 0)
+	{
+		GenerateScriptedTimeline();
+		LoopLength = ScriptedLength;
+	}
+
+	if (LoopLength <= 0.f && Events.Num() > 0)
+	{
+		LoopLength = Events.Last().Time;
+	}
+}
+
+void ABotPlayerController::SetPawn(APawn* InPawn)
+{
+	ReleaseButtons();
+
+	Super::SetPawn(InPawn);
+
+	BotCharacter = Cast<AMainCharacter>(InPawn);
+}
+
+void ABotPlayerController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (BotCharacter == nullptr || Events.Num() == 0) return;
+
+	TimelineTime += DeltaTime;
+
+	while (NextEvent < Events.Num() && Events[NextEvent].Time <= TimelineTime)
+	{
+		ApplyInput(Events[NextEvent]);
+		++NextEvent;
+	}
+
+	if (NextEvent >= Events.Num() && bLoop && TimelineTime >= LoopLength)
+	{
+		ReleaseButtons();
+		TimelineTime = LoopLength > 0.f ? FMath::Fmod(TimelineTime, LoopLength) : 0.f;
+		NextEvent = 0;
+	}
+
+	ApplyAxes();
+}
+
+void ABotPlayerController::GenerateScriptedTimeline()
+{
+	Events.Reset();
+
+	auto AddEvent = [this](float Time, EBotInput Input, float Value)
+	{
+		FBotInputEvent& Event = Events.AddDefaulted_GetRef();
+		Event.Time = Time;
+		Event.Input = Input;
+		Event.Value = Value;
+	};
+
+	// Wander in short segments, shooting in bursts and picking things up along the way
+	float Time{ 0.f };
+	while (Time < ScriptedLength)
+	{
+		const float SegmentLength{ RandomStream.FRandRange(1.f, 3.f) };
+		const float SegmentEnd{ FMath::Min(Time + SegmentLength, ScriptedLength) };
+
+		AddEvent(Time, EBotInput::EBI_MoveForward, RandomStream.FRandRange(-0.5f, 1.f));
+		AddEvent(Time, EBotInput::EBI_MoveRight, RandomStream.FRandRange(-1.f, 1.f));
+		AddEvent(Time, EBotInput::EBI_Turn, RandomStream.FRandRange(-0.5f, 0.5f));
+
+		if (RandomStream.FRand() < 0.6f)
+		{
+			const float BurstStart{ Time + RandomStream.FRandRange(0.f, 0.5f) };
+			AddEvent(BurstStart, EBotInput::EBI_Fire, 1.f);
+			AddEvent(FMath::Min(BurstStart + RandomStream.FRandRange(0.3f, 1.5f), SegmentEnd), EBotInput::EBI_Fire, 0.f);
+		}
+		if (RandomStream.FRand() < 0.15f)
+		{
+			AddEvent(Time, EBotInput::EBI_Reload, 1.f);
+		}
+		if (RandomStream.FRand() < 0.2f)
+		{
+			AddEvent(Time, EBotInput::EBI_Interact, 1.f);
+			AddEvent(FMath::Min(Time + 0.1f, SegmentEnd), EBotInput::EBI_Interact, 0.f);
+		}
+		if (RandomStream.FRand() < 0.1f)
+		{
+			AddEvent(Time, EBotInput::EBI_SelectSlot, RandomStream.RandRange(0, UInventoryComponent::INVENTORY_CAPACITY - 1));
+		}
+
+		Time = SegmentEnd;
+	}
+
+	Events.StableSort([](const FBotInputEvent& A, const FBotInputEvent& B)
+	{
+		return A.Time < B.Time;
+	});
+}
+
+void ABotPlayerController::ApplyInput(const FBotInputEvent& Event)
+{
+	const bool bPressed{ Event.Value != 0.f };
+
+	switch (Event.Input)
+	{
+	case EBotInput::EBI_MoveForward:
+		ForwardAxis = Event.Value;
+		break;
+	case EBotInput::EBI_MoveRight:
+		RightAxis = Event.Value;
+		break;
+	case EBotInput::EBI_Turn:
+		TurnAxis = Event.Value;
+		break;
+	case EBotInput::EBI_LookUp:
+		LookUpAxis = Event.Value;
+		break;
+	case EBotInput::EBI_Fire:
+		if (bPressed == bFireHeld) break;
+		bFireHeld = bPressed;
+		bPressed ? BotCharacter->FireButtonPressed() : BotCharacter->FireButtonReleased();
+		break;
+	case EBotInput::EBI_Aim:
+		if (bPressed == bAimHeld) break;
+		bAimHeld = bPressed;
+		bPressed ? BotCharacter->AimingButtonPressed() : BotCharacter->AimingButtonReleased();
+		break;
+	case EBotInput::EBI_Interact:
+		if (bPressed == bInteractHeld) break;
+		bInteractHeld = bPressed;
+		bPressed ? BotCharacter->InteractButtonPressed() : BotCharacter->InteractButtonReleased();
+		break;
+	case EBotInput::EBI_Reload:
+		if (bPressed)
+		{
+			BotCharacter->ReloadButtonPressed();
+		}
+		break;
+	case EBotInput::EBI_SelectSlot:
+		BotCharacter->SelectInventorySlot(FMath::RoundToInt(Event.Value));
+		break;
+	default:
+		break;
+	}
+}
+
+void ABotPlayerController::ApplyAxes()
+{
+	BotCharacter->MoveForward(ForwardAxis);
+	BotCharacter->MoveRight(RightAxis);
+	BotCharacter->TurnAtRate(TurnAxis);
+	BotCharacter->LookUpAtRate(LookUpAxis);
+}
+
+void ABotPlayerController::ReleaseButtons()
+{
+	if (BotCharacter)
+	{
+		if (bFireHeld) BotCharacter->FireButtonReleased();
+		if (bAimHeld) BotCharacter->AimingButtonReleased();
+		if (bInteractHeld) BotCharacter->InteractButtonReleased();
+	}
+
+	bFireHeld = false;
+	bAimHeld = false;
+	bInteractHeld = false;
+}
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MainPlayerController.h"
+#include "BotInputTimeline.h"
+#include "BotPlayerController.generated.h"
+
+/**
+ * Player controller that drives the main character from an input timeline
+ * instead of devices, giving a repeatable workload for profiling. The
+ * timeline comes from -BotTimeline=<csv>, the Timeline asset, or is generated
+ * from a seed drawn from the game mode's bot stream (or Seed, with -BotSeed=<n>).
+ * Timelines can be recorded from a human player with -BotRecord=<csv>. Run with
+ * -benchmark -fps=<n> so timeline time advances the same way on every run.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API ABotPlayerController : public AMainPlayerController
+{
+	GENERATED_BODY()
+public:
+	ABotPlayerController();
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void SetPawn(APawn* InPawn) override;
+
+	/** Fill Events with Length seconds of random movement, shooting and pickups */
+	void GenerateScriptedTimeline();
+
+	void ApplyInput(const FBotInputEvent& Event);
+
+	/** Apply the held axis values to the character */
+	void ApplyAxes();
+
+	void ReleaseButtons();
+
+private:
+	/** Authored or recorded timeline; a scripted one is generated when unset */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	UBotInputTimeline* Timeline;
+
+	/** Seed for the scripted timeline when -BotSeed= is given */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	int32 Seed;
+
+	/** Length of the generated timeline before it loops */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float ScriptedLength;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	class AMainCharacter* BotCharacter;
+
+	FRandomStream RandomStream;
+
+	TArray<FBotInputEvent> Events;
+	bool bLoop;
+	float LoopLength;
+
+	float TimelineTime;
+	int32 NextEvent;
+
+	/** Axis values held until the next event for that axis */
+	float ForwardAxis;
+	float RightAxis;
+	float TurnAxis;
+	float LookUpAxis;
+
+	bool bFireHeld;
+	bool bAimHeld;
+	bool bInteractHeld;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CrosshairAtlas.generated.h"
+
+UENUM(BlueprintType)
+enum class ECrosshairPiece : uint8
+{
+	ECP_Middle UMETA(DisplayName = "Middle"),
+	ECP_Left UMETA(DisplayName = "Left"),
+	ECP_Right UMETA(DisplayName = "Right"),
+	ECP_Top UMETA(DisplayName = "Top"),
+	ECP_Bottom UMETA(DisplayName = "Bottom"),
+
+	ECP_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/** Part of the atlas texture holding one crosshair piece, in UV space */
+USTRUCT(BlueprintType)
+struct FCrosshairAtlasRegion
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector2D UV{ 0.f, 0.f };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector2D UVSize{ 1.f, 1.f };
+};
+
+/** All crosshair pieces of a weapon packed into one texture */
+USTRUCT(BlueprintType)
+struct FCrosshairAtlas
+{
+	GENERATED_BODY()
+
+	/** Default layout: the five pieces side by side in a single row */
+	FCrosshairAtlas()
+	{
+		constexpr int32 NumPieces{ static_cast<int32>(ECrosshairPiece::ECP_MAX) };
+		for (int32 Piece = 0; Piece < NumPieces; ++Piece)
+		{
+			Regions[Piece].UV = FVector2D(static_cast<float>(Piece) / NumPieces, 0.f);
+			Regions[Piece].UVSize = FVector2D(1.f / NumPieces, 1.f);
+		}
+	}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UTexture2D* Texture{ nullptr };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ArraySizeEnum = "ECrosshairPiece"))
+	FCrosshairAtlasRegion Regions[static_cast<uint8>(ECrosshairPiece::ECP_MAX)];
+
+	FORCEINLINE const FCrosshairAtlasRegion& GetRegion(ECrosshairPiece Piece) const
+	{
+		return Regions[static_cast<uint8>(Piece)];
+	}
+};
@@ -15,12 +15,22 @@
 #include "Components/CapsuleComponent.h"
 #include "Components/BoxComponent.h"
 #include "Engine/SkeletalMeshSocket.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "HitscanSubsystem.h"
+#include "HealthBarSubsystem.h"
+#include "ZombieTeamProject.h"
+#include "GameplayTelemetry.h"
+#include "ZombieTeamProjectGameMode.h"
+#include "Net/UnrealNetwork.h"
 
 
 // Sets default values
 AEnemy::AEnemy() :
 	Health(100.f),
 	MaxHealth(100.f),
+	HeadDamageMultiplier(1.f),
+	TorsoDamageMultiplier(1.f),
+	LimbDamageMultiplier(0.75f),
 	HealthBarDisplayTime(4.f),
 	CanHitReact(true),
 	HitReactTimeMin(.5f),
@@ -36,11 +46,24 @@ AEnemy::AEnemy() :
 	EnemyCanAttack(true),
 	AttackWaitTime(1.f),
 	isDying(false),
-	DeathTime(4.f)
+	DeathTime(4.f),
+	NetDormancyDelay(2.f),
+	LastNetActiveTime(0.f)
 {
+	LLM_SCOPE_BYTAG(ZombieEnemies);
+
 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+	// A horde is hundreds of characters: replicate them less often, less precisely and not at all when far away
+	NetUpdateFrequency = 10.f;
+	MinNetUpdateFrequency = 2.f;
+	NetCullDistanceSquared = FMath::Square(8000.f);
+	FRepMovement& RepMovement = GetReplicatedMovement_Mutable();
+	RepMovement.LocationQuantizationLevel = EVectorQuantization::RoundWholeNumber;
+	RepMovement.VelocityQuantizationLevel = EVectorQuantization::RoundWholeNumber;
+	RepMovement.RotationQuantizationLevel = ERotatorQuantization::ByteComponents;
+
 	// Create the Agro Sphere
 	AgroSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AgroSphere"));
 	AgroSphere->SetupAttachment(GetRootComponent());
@@ -54,13 +77,28 @@ AEnemy::AEnemy() :
 	LeftArmCollision->SetupAttachment(GetMesh(), FName("LeftArmBone"));
 	RightArmCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("Right Arm Box"));
 	RightArmCollision->SetupAttachment(GetMesh(), FName("RightArmBone"));
+
+	for (float& Multiplier : HitZoneDamageMultipliers)
+	{
+		Multiplier = 1.f;
+	}
 }
 
 // Called when the game starts or when spawned
 void AEnemy::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(ZombieEnemies);
+
 	Super::BeginPlay();
 
+	INC_DWORD_STAT(STAT_ZombieLiveEnemies);
+
+	if (HasAuthority())
+	{
+		UpdateReplicatedHealth();
+		LastNetActiveTime = GetWorld()->GetTimeSeconds();
+	}
+
 	AgroSphere->OnComponentBeginOverlap.AddDynamic(
 		this,
 		&AEnemy::AgroSphereOverlap);
@@ -93,21 +131,43 @@ void AEnemy::BeginPlay()
 		ECollisionChannel::ECC_Pawn,
 		ECollisionResponse::ECR_Overlap);
 
+	// Only bullets hit the mesh; item and camera traces pass through enemies
+	GetMesh()->SetCollisionObjectType(ECC_EnemyHitbox);
 	GetMesh()->SetCollisionResponseToChannel(
-		ECollisionChannel::ECC_Visibility,
+		ECC_Bullet,
 		ECollisionResponse::ECR_Block);
+	GetMesh()->SetCollisionResponseToChannel(
+		ECollisionChannel::ECC_Visibility,
+		ECollisionResponse::ECR_Ignore);
+	GetMesh()->SetCollisionResponseToChannel(
+		ECC_Interactable,
+		ECollisionResponse::ECR_Ignore);
 	GetMesh()->SetCollisionResponseToChannel(
 		ECollisionChannel::ECC_Camera,
 		ECollisionResponse::ECR_Ignore);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(
 		ECollisionChannel::ECC_Camera,
 		ECollisionResponse::ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(
+		ECC_Bullet,
+		ECollisionResponse::ECR_Ignore);
+	GetCapsuleComponent()->SetCollisionResponseToChannel(
+		ECC_Interactable,
+		ECollisionResponse::ECR_Ignore);
+
+	BuildHitZoneTable();
+
+	if (UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>())
+	{
+		Hitscan->RegisterEnemy(this);
+	}
 
 	// Get the AI Controller
 	EnemyController = Cast<AEnemyController>(GetController());
 
 	if (EnemyController)
 	{
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsBool(
 			FName("EnemyCanAttack"),
 			true);
@@ -120,45 +180,75 @@ void AEnemy::BeginPlay()
 		GetActorTransform(),
 		PatrolPoint2);
 
-	DrawDebugSphere(
-		GetWorld(),
-		WorldPatrolPoint,
-		25.f,
-		12,
-		FColor::Red,
-		true
-	);
-	DrawDebugSphere(
-		GetWorld(),
-		WorldPatrolPoint2,
-		25.f,
-		12,
-		FColor::Red,
-		true
-	);
+	if (ShouldPlayCosmetics(this))
+	{
+		DrawDebugSphere(
+			GetWorld(),
+			WorldPatrolPoint,
+			25.f,
+			12,
+			FColor::Red,
+			true
+		);
+		DrawDebugSphere(
+			GetWorld(),
+			WorldPatrolPoint2,
+			25.f,
+			12,
+			FColor::Red,
+			true
+		);
+	}
 
 	if (EnemyController)
 	{
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsVector(
 			TEXT("PatrolPoint"),
 			WorldPatrolPoint);
 
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsVector(
 			TEXT("PatrolPoint2"),
 			WorldPatrolPoint2);
 
+		// Behavior tree and blackboard instances belong to the AI budget
+		LLM_SCOPE_BYTAG(ZombieAI);
 		EnemyController->RunBehaviorTree(BehaviorTree);
 	}
 }
 
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT(STAT_ZombieLiveEnemies);
+	DEC_DWORD_STAT_BY(STAT_ZombieLiveHitNumbers, HitNumbers.Num());
+
+	if (UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>())
+	{
+		Hitscan->UnregisterEnemy(this);
+	}
+	if (ShouldPlayCosmetics(this))
+	{
+		HideHealthBar();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AEnemy::ShowHealthBar_Implementation()
 {
-	GetWorldTimerManager().ClearTimer(HealthBarTimer);
-	GetWorldTimerManager().SetTimer(
-		HealthBarTimer,
-		this,
-		&AEnemy::HideHealthBar,
-		HealthBarDisplayTime);
+	if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>())
+	{
+		HealthBars->ShowHealthBar(this, Health / MaxHealth, HealthBarDisplayTime);
+	}
+}
+
+void AEnemy::HideHealthBar_Implementation()
+{
+	if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>())
+	{
+		HealthBars->HideHealthBar(this);
+	}
 }
 
 void AEnemy::EnemyDeath()
@@ -166,16 +256,15 @@ void AEnemy::EnemyDeath()
 	if (isDying) return;
 	isDying = true;
 
-	HideHealthBar();
-
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && DeathMontage)
+	if (ShouldPlayCosmetics(this))
 	{
-		AnimInstance->Montage_Play(DeathMontage);
+		HideHealthBar();
 	}
+	PlayDeathMontage();
 
 	if (EnemyController)
 	{
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsBool(
 			FName("Dead"),
 			true
@@ -184,6 +273,60 @@ void AEnemy::EnemyDeath()
 	}
 }
 
+void AEnemy::PlayDeathMontage()
+{
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance && DeathMontage)
+	{
+		AnimInstance->Montage_Play(DeathMontage);
+	}
+}
+
+void AEnemy::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AEnemy, ReplicatedHealth);
+	DOREPLIFETIME(AEnemy, isStunned);
+	DOREPLIFETIME(AEnemy, isDying);
+}
+
+void AEnemy::UpdateReplicatedHealth()
+{
+	// Round up so a living enemy never shows an empty bar
+	const float HealthFraction{ MaxHealth > 0.f ? FMath::Clamp(Health / MaxHealth, 0.f, 1.f) : 0.f };
+	ReplicatedHealth = static_cast<uint8>(FMath::CeilToInt(HealthFraction * 255.f));
+}
+
+void AEnemy::OnRep_Health()
+{
+	Health = ReplicatedHealth / 255.f * MaxHealth;
+
+	if (isDying) return;
+
+	ShowHealthBar();
+}
+
+void AEnemy::OnRep_Stunned()
+{
+	if (!isStunned) return;
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance && HitMontage)
+	{
+		AnimInstance->Montage_Play(HitMontage);
+		AnimInstance->Montage_JumpToSection(FName("HitReactFront"), HitMontage);
+	}
+}
+
+void AEnemy::OnRep_Dying()
+{
+	if (!isDying) return;
+
+	HideHealthBar();
+	PlayDeathMontage();
+}
+
 void AEnemy::PlayHitMontage(FName Section, float PlayRate)
 {
 	if (CanHitReact)
@@ -196,7 +339,7 @@ void AEnemy::PlayHitMontage(FName Section, float PlayRate)
 		}
 
 		CanHitReact = false;
-		const float HitReactTime{ FMath::FRandRange(HitReactTimeMin, HitReactTimeMax) };
+		const float HitReactTime{ AZombieTeamProjectGameMode::GetRandomStream(this, EGameplayRandomStream::EGRS_Combat).FRandRange(HitReactTimeMin, HitReactTimeMax) };
 		GetWorldTimerManager().SetTimer(
 			HitReactTimer,
 			this,
@@ -212,7 +355,10 @@ void AEnemy::ResetHitReactTimer()
 
 void AEnemy::StoreHitNumber(UUserWidget* HitNumber, FVector Location)
 {
+	LLM_SCOPE_BYTAG(ZombieWidgets);
+
 	HitNumbers.Add(HitNumber, Location);
+	INC_DWORD_STAT(STAT_ZombieLiveHitNumbers);
 
 	FTimerHandle HitNumberTimer;
 	FTimerDelegate HitNumberDelegate;
@@ -226,12 +372,17 @@ void AEnemy::StoreHitNumber(UUserWidget* HitNumber, FVector Location)
 
 void AEnemy::DestroyHitNumber(UUserWidget* HitNumber)
 {
-	HitNumbers.Remove(HitNumber);
+	if (HitNumbers.Remove(HitNumber) > 0)
+	{
+		DEC_DWORD_STAT(STAT_ZombieLiveHitNumbers);
+	}
 	HitNumber->RemoveFromParent();
 }
 
 void AEnemy::UpdateHitNumbers()
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_UpdateHitNumbers);
+
 	for (auto& HitPair : HitNumbers)
 	{
 		UUserWidget* HitNumber{ HitPair.Key };
@@ -245,14 +396,80 @@ void AEnemy::UpdateHitNumbers()
 	}
 }
 
+int32 AEnemy::GetNumActiveTimers() const
+{
+	const FTimerManager& TimerManager = GetWorldTimerManager();
+	return TimerManager.IsTimerActive(HitReactTimer) +
+		TimerManager.IsTimerActive(AttackWaitTimer) +
+		TimerManager.IsTimerActive(DeathTimer) +
+		HitNumbers.Num();
+}
+
+void AEnemy::BuildHitZoneTable()
+{
+	HitZoneDamageMultipliers[static_cast<uint8>(EHitZone::EHZ_Torso)] = TorsoDamageMultiplier;
+	HitZoneDamageMultipliers[static_cast<uint8>(EHitZone::EHZ_Head)] = HeadDamageMultiplier;
+	HitZoneDamageMultipliers[static_cast<uint8>(EHitZone::EHZ_Limb)] = LimbDamageMultiplier;
+
+	BodyHitZones.Reset();
+
+	const UPhysicsAsset* PhysicsAsset = GetMesh()->GetPhysicsAsset();
+	if (PhysicsAsset == nullptr) return;
+
+	TMap<FName, EHitZone> ZoneRoots;
+	for (const FHitZoneBone& HitZoneBone : HitZoneBones)
+	{
+		ZoneRoots.Add(HitZoneBone.BoneName, HitZoneBone.Zone);
+	}
+	if (!HeadBone.IsNone())
+	{
+		ZoneRoots.Add(HeadBone, EHitZone::EHZ_Head);
+	}
+
+	// Body indices match the order of the physics asset body setups
+	BodyHitZones.Init(EHitZone::EHZ_Torso, PhysicsAsset->SkeletalBodySetups.Num());
+	for (int32 BodyIndex = 0; BodyIndex < BodyHitZones.Num(); ++BodyIndex)
+	{
+		const USkeletalBodySetup* BodySetup = PhysicsAsset->SkeletalBodySetups[BodyIndex];
+		if (BodySetup == nullptr) continue;
+
+		// Walk up the skeleton until we reach a bone that starts a zone
+		for (FName BoneName = BodySetup->BoneName; !BoneName.IsNone(); BoneName = GetMesh()->GetParentBone(BoneName))
+		{
+			if (const EHitZone* Zone = ZoneRoots.Find(BoneName))
+			{
+				BodyHitZones[BodyIndex] = *Zone;
+				break;
+			}
+		}
+	}
+}
+
+int32 AEnemy::FindHitBodyIndex(FName BoneName) const
+{
+	const UPhysicsAsset* PhysicsAsset = GetMesh()->GetPhysicsAsset();
+	if (PhysicsAsset == nullptr) return INDEX_NONE;
+
+	for (; !BoneName.IsNone(); BoneName = GetMesh()->GetParentBone(BoneName))
+	{
+		const int32 BodyIndex{ PhysicsAsset->FindBodyIndex(BoneName) };
+		if (BodyIndex != INDEX_NONE) return BodyIndex;
+	}
+	return INDEX_NONE;
+}
+
 void AEnemy::AgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_EnemyOverlapEvents);
+	INC_DWORD_STAT(STAT_ZombieOverlaps);
+
 	if (OtherActor == nullptr) return;
 
 	auto Character = Cast<AMainCharacter>(OtherActor);
-	if (Character)
+	if (Character && EnemyController)
 	{
 		// Set the value of the Target Blackboard Key
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsObject(
 			TEXT("Target"),
 			Character);
@@ -261,10 +478,12 @@ void AEnemy::AgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 
 void AEnemy::SetStunned(bool Stunned)
 {
+	WakeForReplication();
 	isStunned = Stunned;
 
 	if (EnemyController)
 	{
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsBool(
 			TEXT("Stunned"),
 			Stunned);
@@ -273,6 +492,9 @@ void AEnemy::SetStunned(bool Stunned)
 
 void AEnemy::CombatRangeOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_EnemyOverlapEvents);
+	INC_DWORD_STAT(STAT_ZombieOverlaps);
+
 	if (OtherActor == nullptr) return;
 	auto ShooterCharacter = Cast<AMainCharacter>(OtherActor);
 	if (ShooterCharacter)
@@ -280,6 +502,7 @@ void AEnemy::CombatRangeOverlap(UPrimitiveComponent* OverlappedComponent, AActor
 		isInAttackRange = true;
 		if (EnemyController)
 		{
+			ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 			EnemyController->GetBlackboardComponent()->SetValueAsBool(
 				TEXT("InAttackRange"),
 				true
@@ -290,6 +513,9 @@ void AEnemy::CombatRangeOverlap(UPrimitiveComponent* OverlappedComponent, AActor
 
 void AEnemy::CombatRangeEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_EnemyOverlapEvents);
+	INC_DWORD_STAT(STAT_ZombieOverlaps);
+
 	if (OtherActor == nullptr) return;
 	auto ShooterCharacter = Cast<AMainCharacter>(OtherActor);
 	if (ShooterCharacter)
@@ -297,6 +523,7 @@ void AEnemy::CombatRangeEndOverlap(UPrimitiveComponent* OverlappedComponent, AAc
 		isInAttackRange = false;
 		if (EnemyController)
 		{
+			ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 			EnemyController->GetBlackboardComponent()->SetValueAsBool(
 				TEXT("InAttackRange"),
 				false
@@ -307,12 +534,8 @@ void AEnemy::CombatRangeEndOverlap(UPrimitiveComponent* OverlappedComponent, AAc
 
 void AEnemy::PlayAttackMontage(FName Section, float PlayRate)
 {
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && AttackMontage)
-	{
-		AnimInstance->Montage_Play(AttackMontage);
-		AnimInstance->Montage_JumpToSection(Section, AttackMontage);
-	}
+	WakeForReplication();
+	MulticastPlayAttackMontage(Section);
 
 	EnemyCanAttack = false;
 	GetWorldTimerManager().SetTimer(
@@ -323,6 +546,7 @@ void AEnemy::PlayAttackMontage(FName Section, float PlayRate)
 	);
 	if (EnemyController)
 	{
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsBool(
 			FName("EnemyCanAttack"),
 			false);
@@ -332,7 +556,7 @@ void AEnemy::PlayAttackMontage(FName Section, float PlayRate)
 FName AEnemy::GetAttackSectionName()
 {
 	FName SectionName;
-	const int32 Section{ FMath::RandRange(1, 4) };
+	const int32 Section{ AZombieTeamProjectGameMode::GetRandomStream(this, EGameplayRandomStream::EGRS_AI).RandRange(1, 4) };
 	switch (Section)
 	{
 	case 1:
@@ -353,11 +577,17 @@ FName AEnemy::GetAttackSectionName()
 
 void AEnemy::OnLeftArmOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_EnemyOverlapEvents);
+	INC_DWORD_STAT(STAT_ZombieOverlaps);
+
 	DoDamage(OtherActor);
 }
 
 void AEnemy::OnRightArmOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_EnemyOverlapEvents);
+	INC_DWORD_STAT(STAT_ZombieOverlaps);
+
 	DoDamage(OtherActor);
 }
 
@@ -383,7 +613,8 @@ void AEnemy::DeactivateRightArm()
 
 void AEnemy::DoDamage(AActor* Victim)
 {
-	if (Victim == nullptr) return;
+	// Arm overlaps also fire on clients playing the attack montage
+	if (Victim == nullptr || !HasAuthority()) return;
 	auto Character = Cast<AMainCharacter>(Victim);
 	if (Character)
 	{
@@ -402,6 +633,7 @@ void AEnemy::ResetCanAttack()
 	EnemyCanAttack = true;
 	if (EnemyController)
 	{
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsBool(
 			FName("EnemyCanAttack"),
 			true);
@@ -432,6 +664,33 @@ void AEnemy::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 
 	UpdateHitNumbers();
+
+	if (HasAuthority())
+	{
+		UpdateNetDormancy();
+	}
+}
+
+void AEnemy::UpdateNetDormancy()
+{
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	if (!GetVelocity().IsNearlyZero() || isInAttackRange || isStunned || isDying)
+	{
+		WakeForReplication();
+	}
+	else if (NetDormancy == DORM_Awake && Now - LastNetActiveTime > NetDormancyDelay)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+}
+
+void AEnemy::WakeForReplication()
+{
+	LastNetActiveTime = GetWorld()->GetTimeSeconds();
+	if (NetDormancy > DORM_Awake)
+	{
+		SetNetDormancy(DORM_Awake);
+	}
 }
 
 // Called to bind functionality to input
@@ -443,21 +702,20 @@ void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 
 void AEnemy::BulletHit_Implementation(FHitResult HitResult)
 {
-	if (ImpactSound)
-	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
-	}
-	if (ImpactParticles)
-	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, HitResult.Location, FRotator(0.f), true);
-	}
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_EnemyBulletHit);
+
+	WakeForReplication();
+	MulticastBulletHitEffects(HitResult.Location);
 
 	if (isDying) return;
 
-	ShowHealthBar();
+	if (ShouldPlayCosmetics(this))
+	{
+		ShowHealthBar();
+	}
 
 	// Determine whether bullet hit stuns
-	const float Stunned = FMath::FRandRange(0.f, 1.f);
+	const float Stunned = AZombieTeamProjectGameMode::GetRandomStream(this, EGameplayRandomStream::EGRS_Combat).FRand();
 	if (Stunned <= StunChance)
 	{
 		// Stun the Enemy
@@ -466,11 +724,43 @@ void AEnemy::BulletHit_Implementation(FHitResult HitResult)
 	}
 }
 
+void AEnemy::MulticastBulletHitEffects_Implementation(FVector_NetQuantize Location)
+{
+	if (!ShouldPlayCosmetics(this)) return;
+
+	if (ImpactSound)
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+	}
+	if (ImpactParticles)
+	{
+		LLM_SCOPE_BYTAG(ZombieFX);
+		INC_DWORD_STAT(STAT_ZombieFXSpawned);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, Location, FRotator(0.f), true);
+	}
+}
+
+void AEnemy::MulticastPlayAttackMontage_Implementation(FName Section)
+{
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance && AttackMontage)
+	{
+		AnimInstance->Montage_Play(AttackMontage);
+		AnimInstance->Montage_JumpToSection(Section, AttackMontage);
+	}
+}
+
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-	// Set the Target Blackboard Key to agro the Character
-	if (EnemyController)
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_EnemyTakeDamage);
+	ZOMBIE_TELEMETRY_INC(DamageEvents);
+
+	WakeForReplication();
+
+	// Set the Target Blackboard Key to agro the Character; explosives are not worth chasing
+	if (EnemyController && Cast<AMainCharacter>(DamageCauser))
 	{
+		ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 		EnemyController->GetBlackboardComponent()->SetValueAsObject(
 			FName("Target"),
 			DamageCauser);
@@ -484,7 +774,13 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 	else
 	{
 		Health -= DamageAmount;
+
+		if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>())
+		{
+			HealthBars->SetHealthFraction(this, Health / MaxHealth);
+		}
 	}
+	UpdateReplicatedHealth();
 	return DamageAmount;
 }
 
@@ -5,8 +5,39 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "BulletHitInterface.h"
+#include "HitZone.h"
 #include "Enemy.generated.h"
 
+USTRUCT(BlueprintType)
+struct FHitZoneBone
+{
+	GENERATED_BODY()
+
+	/** Bone whose physics body (and every body below it) belongs to Zone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName BoneName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EHitZone Zone;
+};
+
+USTRUCT(BlueprintType)
+struct FHitCapsule
+{
+	GENERATED_BODY()
+
+	/** Bone at one end of the capsule; its physics body decides the hit zone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName StartBone;
+
+	/** Bone at the other end of the capsule, none for a sphere around StartBone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName EndBone;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Radius;
+};
+
 UCLASS()
 class ZOMBIETEAMPROJECT_API AEnemy : public ACharacter, public IBulletHitInterface
 {
@@ -20,12 +51,15 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION(BlueprintNativeEvent)
 		void ShowHealthBar();
 	void ShowHealthBar_Implementation();
 
-	UFUNCTION(BlueprintImplementableEvent)
+	UFUNCTION(BlueprintNativeEvent)
 		void HideHealthBar();
+	void HideHealthBar_Implementation();
 
 	void EnemyDeath();
 
@@ -41,6 +75,9 @@ protected:
 
 	void UpdateHitNumbers();
 
+	/** Resolve HitZoneBones against the physics asset into BodyHitZones */
+	void BuildHitZoneTable();
+
 	/** Called when something overlaps with the agro sphere */
 	UFUNCTION()
 		void AgroSphereOverlap(
@@ -102,6 +139,34 @@ protected:
 	UFUNCTION()
 	void DestroyEnemy();
 
+	/** Start the death montage; shared by EnemyDeath and replicated deaths */
+	void PlayDeathMontage();
+
+	UFUNCTION()
+	void OnRep_Health();
+
+	UFUNCTION()
+	void OnRep_Stunned();
+
+	UFUNCTION()
+	void OnRep_Dying();
+
+	/** Quantize Health into ReplicatedHealth; call after every server-side health change */
+	void UpdateReplicatedHealth();
+
+	/** Impact sound and particles for every client that has this enemy relevant */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastBulletHitEffects(FVector_NetQuantize Location);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastPlayAttackMontage(FName Section);
+
+	/** Put idle enemies to sleep on the network and wake them as soon as they act */
+	void UpdateNetDormancy();
+
+	/** Leave dormancy before changing replicated state or sending a multicast */
+	void WakeForReplication();
+
 private:
 	/** Particles to spawn when hit by bullets */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -115,18 +180,44 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		float Health;
 
+	/** Health as a fraction of MaxHealth in 1/255 steps, replicated for the health bars */
+	UPROPERTY(ReplicatedUsing = OnRep_Health)
+	uint8 ReplicatedHealth;
+
 	/** Maximum health of the enemy */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		float MaxHealth;
 
 	/** Name of the head bone */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-		FString HeadBone;
+		FName HeadBone;
 
+	/** Bones that start a hit zone; child bones inherit the zone of their nearest listed parent */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-		float HealthBarDisplayTime;
+		TArray<FHitZoneBone> HitZoneBones;
+
+	/** Damage multipliers applied to the weapon damage for each hit zone */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float HeadDamageMultiplier;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float TorsoDamageMultiplier;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float LimbDamageMultiplier;
+
+	/** Capsules bullets are tested against, refreshed from the bones every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		TArray<FHitCapsule> HitCapsules;
 
-	FTimerHandle HealthBarTimer;
+	/** Hit zone for each physics body, indexed by the body index reported in FHitResult::Item */
+	TArray<EHitZone> BodyHitZones;
+
+	/** Multipliers indexed by EHitZone, resolved once in BuildHitZoneTable */
+	float HitZoneDamageMultipliers[static_cast<uint8>(EHitZone::EHZ_MAX)];
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float HealthBarDisplayTime;
 
 	/** Montage containing Hit and Death animations */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -169,7 +260,7 @@ private:
 		class USphereComponent* AgroSphere;
 
 	/** True when playing the get hit animation */
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_Stunned, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		bool isStunned;
 
 	/** Chance of being stunned. 0: no stun chance, 1: 100% stun chance */
@@ -220,6 +311,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	UAnimMontage* DeathMontage;
 
+	UPROPERTY(ReplicatedUsing = OnRep_Dying)
 	bool isDying;
 
 	FTimerHandle DeathTimer;
@@ -228,6 +320,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float DeathTime;
 
+	/** Seconds an enemy has to stay idle before it goes dormant */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Network, meta = (AllowPrivateAccess = "true"))
+	float NetDormancyDelay;
+
+	/** World time the enemy last moved, attacked or was hit */
+	float LastNetActiveTime;
+
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -235,12 +334,33 @@ public:
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 
 	virtual void BulletHit_Implementation(FHitResult HitResult) override;
 
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
-	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
+	FORCEINLINE FName GetHeadBone() const { return HeadBone; }
+
+	/** Hit zone of the physics body hit by a trace; bodies without a zone count as torso */
+	FORCEINLINE EHitZone GetHitZone(const FHitResult& HitResult) const
+	{
+		return BodyHitZones.IsValidIndex(HitResult.Item) ? BodyHitZones[HitResult.Item] : EHitZone::EHZ_Torso;
+	}
+
+	FORCEINLINE float GetHitZoneDamageMultiplier(EHitZone Zone) const
+	{
+		return HitZoneDamageMultipliers[static_cast<uint8>(Zone)];
+	}
+
+	/** Physics body of the bone, or of its nearest parent that has one */
+	int32 FindHitBodyIndex(FName BoneName) const;
+
+	FORCEINLINE const TArray<FHitCapsule>& GetHitCapsules() const { return HitCapsules; }
+
+	/** Pending gameplay timers, including one per live hit number */
+	int32 GetNumActiveTimers() const;
 
 	UFUNCTION(BlueprintImplementableEvent)
 		void ShowHitNumber(int32 Damage, FVector HitLocation);
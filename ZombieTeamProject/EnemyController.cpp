@@ -6,9 +6,12 @@
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "Enemy.h"
+#include "ZombieTeamProject.h"
 
 AEnemyController::AEnemyController()
 {
+	LLM_SCOPE_BYTAG(ZombieAI);
+
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
 	check(BlackboardComponent);
 
@@ -18,6 +21,8 @@ AEnemyController::AEnemyController()
 
 void AEnemyController::OnPossess(APawn* InPawn)
 {
+	LLM_SCOPE_BYTAG(ZombieAI);
+
 	Super::OnPossess(InPawn);
 	if (InPawn == nullptr) return;
 
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ExplosionSubsystem.h"
+#include "Explosive.h"
+#include "TimerManager.h"
+
+static TAutoConsoleVariable<int32> CVarMaxDetonationsPerFrame(
+	TEXT("zombie.Explosive.MaxDetonationsPerFrame"),
+	4,
+	TEXT("Maximum number of chained explosives detonated in a single frame."));
+
+void UExplosionSubsystem::QueueDetonation(AExplosive* Explosive)
+{
+	if (Explosive == nullptr) return;
+
+	PendingDetonations.Add(Explosive);
+
+	if (!GetWorld()->GetTimerManager().TimerExists(DetonationTimer))
+	{
+		DetonationTimer = GetWorld()->GetTimerManager().SetTimerForNextTick(
+			this,
+			&UExplosionSubsystem::ProcessPendingDetonations);
+	}
+}
+
+void UExplosionSubsystem::ProcessPendingDetonations()
+{
+	// Detonations below may queue more explosives; those wait for the next frame. The handle stays
+	// valid until the batch is done so those queue calls see this timer and do not schedule their own
+	const int32 Budget{ FMath::Max(CVarMaxDetonationsPerFrame.GetValueOnGameThread(), 1) };
+	const int32 NumToProcess{ FMath::Min(Budget, PendingDetonations.Num()) };
+
+	TArray<TWeakObjectPtr<AExplosive>, TInlineAllocator<16>> Batch;
+	Batch.Append(PendingDetonations.GetData(), NumToProcess);
+	PendingDetonations.RemoveAt(0, NumToProcess, false);
+
+	for (const TWeakObjectPtr<AExplosive>& Explosive : Batch)
+	{
+		if (Explosive.IsValid())
+		{
+			Explosive->Detonate(Explosive->GetActorLocation());
+		}
+	}
+
+	DetonationTimer.Invalidate();
+	if (PendingDetonations.Num() > 0)
+	{
+		DetonationTimer = GetWorld()->GetTimerManager().SetTimerForNextTick(
+			this,
+			&UExplosionSubsystem::ProcessPendingDetonations);
+	}
+}
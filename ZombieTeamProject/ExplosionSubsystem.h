@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ExplosionSubsystem.generated.h"
+
+/**
+ * Schedules chained explosive detonations across frames so a long chain
+ * reaction is spread out instead of resolving inside a single frame.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UExplosionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Queue an explosive to detonate on a later frame */
+	void QueueDetonation(class AExplosive* Explosive);
+
+private:
+	void ProcessPendingDetonations();
+
+	/** Explosives waiting to detonate, in the order they were caught in a blast */
+	TArray<TWeakObjectPtr<AExplosive>> PendingDetonations;
+
+	FTimerHandle DetonationTimer;
+};
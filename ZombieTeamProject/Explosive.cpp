@@ -5,12 +5,28 @@
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "Enemy.h"
+#include "MainCharacter.h"
+#include "ExplosionSubsystem.h"
+#include "ZombieTeamProject.h"
+#include "Net/UnrealNetwork.h"
+#include "Engine/World.h"
 
 // Sets default values
-AExplosive::AExplosive()
+AExplosive::AExplosive() :
+	ExplosionDamage(150.f),
+	ExplosionInnerRadius(150.f),
+	ExplosionOuterRadius(500.f),
+	MinDamageFraction(0.2f),
+	isDetonating(false),
+	isDetonated(false),
+	DetonationOrigin(FVector::ZeroVector),
+	DestroyDelay(1.f)
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Explosives only react to bullet hits and never need to tick
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = true;
 
 }
 
@@ -21,26 +37,163 @@ void AExplosive::BeginPlay()
 	
 }
 
-// Called every frame
-void AExplosive::Tick(float DeltaTime)
+void AExplosive::BulletHit_Implementation(FHitResult HitResult)
+{
+	Detonate(HitResult.Location);
+}
+
+void AExplosive::Detonate(const FVector& Origin)
 {
-	Super::Tick(DeltaTime);
+	if (IsPendingKill() || isDetonated) return;
+	isDetonating = true;
+	isDetonated = true;
+	DetonationOrigin = Origin;
+
+	PlayDetonationEffects(Origin);
 
+	ApplyRadialDamage(Origin);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetLifeSpan(DestroyDelay);
 }
 
-void AExplosive::BulletHit_Implementation(FHitResult HitResult)
+void AExplosive::PlayDetonationEffects(const FVector& Origin)
 {
+	if (!ShouldPlayCosmetics(this)) return;
+
 	if (ImpactSound)
 	{
 		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
 	}
 	if (ExplodeParticles)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplodeParticles, HitResult.Location, FRotator(0.f), true);
+		LLM_SCOPE_BYTAG(ZombieFX);
+		INC_DWORD_STAT(STAT_ZombieFXSpawned);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplodeParticles, Origin, FRotator(0.f), true);
+	}
+}
+
+void AExplosive::OnRep_Detonated()
+{
+	if (isDetonated)
+	{
+		PlayDetonationEffects(DetonationOrigin);
 	}
+}
+
+void AExplosive::OnOcclusionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (!PendingVictims.IsValidIndex(TraceDatum.UserData)) return;
 
-	// TODO: Apply explosive damage
+	const FPendingBlastVictim& Pending = PendingVictims[TraceDatum.UserData];
+	AActor* Victim = Pending.Victim.Get();
+	if (Victim == nullptr) return;
+
+	// Cover between the blast and the victim absorbs the damage
+	if (TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit) return;
+
+	UGameplayStatics::ApplyDamage(
+		Victim,
+		Pending.Damage,
+		GetInstigatorController(),
+		this,
+		UDamageType::StaticClass());
+}
+
+void AExplosive::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	Destroy();
+	DOREPLIFETIME(AExplosive, isDetonated);
+	DOREPLIFETIME(AExplosive, DetonationOrigin);
 }
 
+void AExplosive::ApplyRadialDamage(const FVector& Origin)
+{
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_ExplosiveRadialDamage);
+
+	// One overlap query against the physics scene gathers every candidate in range
+	FCollisionObjectQueryParams ObjectQueryParams;
+	ObjectQueryParams.AddObjectTypesToQuery(ECollisionChannel::ECC_Pawn);
+	ObjectQueryParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
+	ObjectQueryParams.AddObjectTypesToQuery(ECollisionChannel::ECC_PhysicsBody);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ExplosiveOverlap), false, this);
+
+	TArray<FOverlapResult> Overlaps;
+	INC_DWORD_STAT(STAT_ZombieOverlaps);
+	GetWorld()->OverlapMultiByObjectType(
+		Overlaps,
+		Origin,
+		FQuat::Identity,
+		ObjectQueryParams,
+		FCollisionShape::MakeSphere(ExplosionOuterRadius),
+		QueryParams);
+
+	// Several components of one actor can overlap, so collect unique actors
+	TArray<AActor*, TInlineAllocator<32>> Victims;
+	TArray<AExplosive*, TInlineAllocator<16>> ChainedExplosives;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* OverlapActor = Overlap.GetActor();
+		if (OverlapActor == nullptr) continue;
+
+		if (AExplosive* Explosive = Cast<AExplosive>(OverlapActor))
+		{
+			if (!Explosive->IsDetonating())
+			{
+				ChainedExplosives.AddUnique(Explosive);
+			}
+		}
+		else if (OverlapActor->IsA<AEnemy>() || OverlapActor->IsA<AMainCharacter>())
+		{
+			Victims.AddUnique(OverlapActor);
+		}
+	}
+
+	// Occlusion checks are issued together as async traces; victims and explosives never block each other
+	FCollisionQueryParams OcclusionParams(SCENE_QUERY_STAT(ExplosiveOcclusion), false, this);
+	for (AActor* Victim : Victims)
+	{
+		OcclusionParams.AddIgnoredActor(Victim);
+	}
+	for (AExplosive* Explosive : ChainedExplosives)
+	{
+		OcclusionParams.AddIgnoredActor(Explosive);
+	}
+
+	const float FalloffRange{ FMath::Max(ExplosionOuterRadius - ExplosionInnerRadius, KINDA_SMALL_NUMBER) };
+	const FTraceDelegate OcclusionDelegate{ FTraceDelegate::CreateUObject(this, &AExplosive::OnOcclusionTraceDone) };
+	PendingVictims.Reset(Victims.Num());
+	for (AActor* Victim : Victims)
+	{
+		const FVector VictimLocation{ Victim->GetActorLocation() };
+		const float Distance{ FVector::Dist(Origin, VictimLocation) };
+		const float Falloff{ FMath::Clamp((Distance - ExplosionInnerRadius) / FalloffRange, 0.f, 1.f) };
+
+		const int32 VictimIndex{ PendingVictims.Add({ Victim, ExplosionDamage * FMath::Lerp(1.f, MinDamageFraction, Falloff) }) };
+
+		INC_DWORD_STAT(STAT_ZombieTraces);
+		GetWorld()->AsyncLineTraceByChannel(
+			EAsyncTraceType::Single,
+			Origin,
+			VictimLocation,
+			ECollisionChannel::ECC_Visibility,
+			OcclusionParams,
+			FCollisionResponseParams::DefaultResponseParam,
+			&OcclusionDelegate,
+			static_cast<uint32>(VictimIndex));
+	}
+
+	// Chained explosives go off on later frames under the subsystem's per-frame budget
+	UExplosionSubsystem* ExplosionSubsystem = GetWorld()->GetSubsystem<UExplosionSubsystem>();
+	for (AExplosive* Explosive : ChainedExplosives)
+	{
+		Explosive->isDetonating = true;
+		if (ExplosionSubsystem)
+		{
+			ExplosionSubsystem->QueueDetonation(Explosive);
+		}
+	}
+}
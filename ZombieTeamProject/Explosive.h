@@ -7,6 +7,9 @@
 #include "BulletHitInterface.h"
 #include "Explosive.generated.h"
 
+struct FTraceHandle;
+struct FTraceDatum;
+
 UCLASS()
 class ZOMBIETEAMPROJECT_API AExplosive : public AActor, public IBulletHitInterface
 {
@@ -20,6 +23,22 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	/**
+	 * Damage every enemy and character inside the blast radius that is not
+	 * behind cover. Cover checks are issued as async traces together and the
+	 * damage lands when they resolve on the next frame.
+	 */
+	void ApplyRadialDamage(const FVector& Origin);
+
+	/** Apply the pending damage for one victim unless its cover trace was blocked */
+	void OnOcclusionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Sound and particles only; clients and replays play them from OnRep_Detonated */
+	void PlayDetonationEffects(const FVector& Origin);
+
+	UFUNCTION()
+	void OnRep_Detonated();
+
 private:
 
 	/** Explosion when hit by a bullet */
@@ -30,9 +49,52 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	class USoundCue* ImpactSound;
 
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	/** Damage dealt at the center of the blast */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float ExplosionDamage;
+
+	/** Full damage is dealt inside this radius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float ExplosionInnerRadius;
+
+	/** Damage falls off to MinDamageFraction at this radius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float ExplosionOuterRadius;
+
+	/** Fraction of ExplosionDamage dealt at the outer radius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float MinDamageFraction;
+
+	/** True once the explosive has gone off or is queued to go off */
+	bool isDetonating;
+
+	/** True once the explosive has gone off; replicated so remote viewers see the blast */
+	UPROPERTY(ReplicatedUsing = OnRep_Detonated)
+	bool isDetonated;
+
+	UPROPERTY(Replicated)
+	FVector_NetQuantize DetonationOrigin;
+
+	/** Time the spent explosive stays hidden so the detonation can replicate before it is destroyed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float DestroyDelay;
 
+	struct FPendingBlastVictim
+	{
+		TWeakObjectPtr<AActor> Victim;
+		float Damage;
+	};
+
+	/** Victims waiting on their cover trace; the trace's user data indexes this array */
+	TArray<FPendingBlastVictim> PendingVictims;
+
+public:	
 	virtual void BulletHit_Implementation(FHitResult HitResult) override;
+
+	/** Play the explosion, damage everything in range and queue nearby explosives */
+	void Detonate(const FVector& Origin);
+
+	FORCEINLINE bool IsDetonating() const { return isDetonating; }
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 };
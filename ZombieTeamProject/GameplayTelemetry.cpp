@@ -0,0 +1,29 @@
+#include "GameplayTelemetry.h"
+
+FGameplayTelemetryCounters GGameplayTelemetry;
+
+const TCHAR* FGameplayTelemetrySample::GetCsvHeader()
+{
+	return TEXT("Frame,Time,DeltaTime,EnemiesNear,EnemiesMid,EnemiesFar,RunningBehaviorTrees,BlackboardWrites,")
+		TEXT("BulletsFired,DamageEvents,ActiveTimers,ActorsSpawned,InstancedLoot,DroppedSamples\n");
+}
+
+void FGameplayTelemetrySample::AppendCsvRow(FString& Out) const
+{
+	Out += FString::Printf(
+		TEXT("%llu,%.3f,%.4f,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n"),
+		FrameNumber,
+		Time,
+		DeltaTime,
+		EnemiesNear,
+		EnemiesMid,
+		EnemiesFar,
+		RunningBehaviorTrees,
+		BlackboardWrites,
+		BulletsFired,
+		DamageEvents,
+		ActiveTimers,
+		ActorsSpawned,
+		InstancedLoot,
+		DroppedSamples);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Gameplay counters for the telemetry stream. Written on the game thread
+ * only and sampled once per frame by UGameplayTelemetrySubsystem, which
+ * resets the per-frame counters after each sample.
+ */
+struct ZOMBIETEAMPROJECT_API FGameplayTelemetryCounters
+{
+	/** Per-frame counters */
+	int32 BulletsFired{ 0 };
+	int32 DamageEvents{ 0 };
+	int32 BlackboardWrites{ 0 };
+	int32 ActorsSpawned{ 0 };
+
+	/** Pickups currently drawn as loot manager instances instead of actors */
+	int32 InstancedLoot{ 0 };
+
+	void ResetFrameCounters()
+	{
+		BulletsFired = 0;
+		DamageEvents = 0;
+		BlackboardWrites = 0;
+		ActorsSpawned = 0;
+	}
+};
+
+extern ZOMBIETEAMPROJECT_API FGameplayTelemetryCounters GGameplayTelemetry;
+
+#define ZOMBIE_TELEMETRY_INC(Counter) (++GGameplayTelemetry.Counter)
+#define ZOMBIE_TELEMETRY_ADD(Counter, Amount) (GGameplayTelemetry.Counter += (Amount))
+
+/** One row of the telemetry CSV */
+struct FGameplayTelemetrySample
+{
+	uint64 FrameNumber{ 0 };
+	double Time{ 0.0 };
+	float DeltaTime{ 0.f };
+
+	/** Enemies by distance to the nearest player */
+	int32 EnemiesNear{ 0 };
+	int32 EnemiesMid{ 0 };
+	int32 EnemiesFar{ 0 };
+
+	/** Enemies whose behavior tree is running, and so ticked this frame */
+	int32 RunningBehaviorTrees{ 0 };
+
+	int32 BlackboardWrites{ 0 };
+	int32 BulletsFired{ 0 };
+	int32 DamageEvents{ 0 };
+
+	/** Gameplay timers pending on enemies and characters */
+	int32 ActiveTimers{ 0 };
+
+	int32 ActorsSpawned{ 0 };
+	int32 InstancedLoot{ 0 };
+
+	/** Samples dropped so far because the writer fell behind */
+	int32 DroppedSamples{ 0 };
+
+	static const TCHAR* GetCsvHeader();
+	void AppendCsvRow(FString& Out) const;
+};
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayTelemetrySubsystem.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "EngineUtils.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Enemy.h"
+#include "MainCharacter.h"
+#include "GameplayTelemetry.h"
+#include "GameplayTelemetryWriter.h"
+
+namespace
+{
+	/** Enemy distance buckets, measured to the nearest player */
+	constexpr float TelemetryNearDistance{ 2000.f };
+	constexpr float TelemetryFarDistance{ 6000.f };
+
+	constexpr int64 TelemetryMaxFileSize{ 16 * 1024 * 1024 };
+	constexpr int32 TelemetryMaxFiles{ 8 };
+}
+
+void UGameplayTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	const bool bEnabled{ FParse::Param(CommandLine, TEXT("ZombieTelemetry")) ||
+		(IsRunningDedicatedServer() && !FParse::Param(CommandLine, TEXT("NoZombieTelemetry"))) };
+	if (bEnabled)
+	{
+		Writer = MakeUnique<FGameplayTelemetryWriter>(
+			FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry")),
+			TelemetryMaxFileSize,
+			TelemetryMaxFiles);
+	}
+}
+
+void UGameplayTelemetrySubsystem::Deinitialize()
+{
+	// Stops the writer thread after it flushes the remaining samples
+	Writer.Reset();
+
+	Super::Deinitialize();
+}
+
+void UGameplayTelemetrySubsystem::GatherEnemySample(const UWorld* World, FGameplayTelemetrySample& Sample) const
+{
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			PlayerLocations.Add(Pawn->GetActorLocation());
+		}
+		if (const AMainCharacter* Character = Cast<AMainCharacter>(Pawn))
+		{
+			Sample.ActiveTimers += Character->GetNumActiveTimers();
+		}
+	}
+
+	for (TActorIterator<AEnemy> It(World); It; ++It)
+	{
+		const AEnemy* Enemy = *It;
+
+		float NearestDistanceSquared{ TNumericLimits<float>::Max() };
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			NearestDistanceSquared = FMath::Min(NearestDistanceSquared, FVector::DistSquared(PlayerLocation, Enemy->GetActorLocation()));
+		}
+
+		if (NearestDistanceSquared <= FMath::Square(TelemetryNearDistance)) ++Sample.EnemiesNear;
+		else if (NearestDistanceSquared <= FMath::Square(TelemetryFarDistance)) ++Sample.EnemiesMid;
+		else ++Sample.EnemiesFar;
+
+		const AAIController* AIController = Cast<AAIController>(Enemy->GetController());
+		const UBrainComponent* Brain = AIController ? AIController->GetBrainComponent() : nullptr;
+		if (Brain && Brain->IsRunning())
+		{
+			++Sample.RunningBehaviorTrees;
+		}
+
+		Sample.ActiveTimers += Enemy->GetNumActiveTimers();
+	}
+}
+
+void UGameplayTelemetrySubsystem::Tick(float DeltaTime)
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr)
+	{
+		GGameplayTelemetry.ResetFrameCounters();
+		return;
+	}
+
+	FGameplayTelemetrySample Sample;
+	Sample.FrameNumber = GFrameCounter;
+	Sample.Time = World->GetRealTimeSeconds();
+	Sample.DeltaTime = DeltaTime;
+	GatherEnemySample(World, Sample);
+	Sample.BlackboardWrites = GGameplayTelemetry.BlackboardWrites;
+	Sample.BulletsFired = GGameplayTelemetry.BulletsFired;
+	Sample.DamageEvents = GGameplayTelemetry.DamageEvents;
+	Sample.ActorsSpawned = GGameplayTelemetry.ActorsSpawned;
+	Sample.InstancedLoot = GGameplayTelemetry.InstancedLoot;
+	Sample.DroppedSamples = DroppedSamples;
+
+	if (!Writer->Enqueue(Sample))
+	{
+		++DroppedSamples;
+	}
+
+	GGameplayTelemetry.ResetFrameCounters();
+}
+
+ETickableTickType UGameplayTelemetrySubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UGameplayTelemetrySubsystem::IsTickable() const
+{
+	return Writer.IsValid();
+}
+
+TStatId UGameplayTelemetrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGameplayTelemetrySubsystem, STATGROUP_Tickables);
+}
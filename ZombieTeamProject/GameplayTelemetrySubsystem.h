@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "GameplayTelemetrySubsystem.generated.h"
+
+/**
+ * Samples gameplay load once per frame and hands the samples to a
+ * background CSV writer in Saved/Telemetry. On by default on dedicated
+ * servers (-NoZombieTelemetry turns it off), opt-in elsewhere with
+ * -ZombieTelemetry.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UGameplayTelemetrySubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	FORCEINLINE bool IsTelemetryEnabled() const { return Writer.IsValid(); }
+
+private:
+	void GatherEnemySample(const UWorld* World, struct FGameplayTelemetrySample& Sample) const;
+
+	TUniquePtr<class FGameplayTelemetryWriter> Writer;
+
+	int32 DroppedSamples{ 0 };
+};
@@ -0,0 +1,115 @@
+#include "GameplayTelemetryWriter.h"
+#include "HAL/FileManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	/** Ring buffer size; about a minute of samples at 60 fps */
+	constexpr uint32 TelemetryQueueSize{ 4096 };
+
+	/** Seconds between flushes */
+	constexpr float TelemetryFlushInterval{ 0.5f };
+
+	const TCHAR* TelemetryFilePrefix{ TEXT("Telemetry_") };
+}
+
+FGameplayTelemetryWriter::FGameplayTelemetryWriter(const FString& InDirectory, int64 InMaxFileSize, int32 InMaxFiles) :
+	Samples(TelemetryQueueSize),
+	Directory(InDirectory),
+	MaxFileSize(InMaxFileSize),
+	MaxFiles(FMath::Max(InMaxFiles, 1)),
+	bStopping(false),
+	Thread(nullptr)
+{
+	IFileManager::Get().MakeDirectory(*Directory, true);
+	Thread = FRunnableThread::Create(this, TEXT("GameplayTelemetryWriter"), 0, TPri_BelowNormal);
+}
+
+FGameplayTelemetryWriter::~FGameplayTelemetryWriter()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+}
+
+bool FGameplayTelemetryWriter::Enqueue(const FGameplayTelemetrySample& Sample)
+{
+	return Samples.Enqueue(Sample);
+}
+
+uint32 FGameplayTelemetryWriter::Run()
+{
+	while (!bStopping)
+	{
+		Flush();
+		FPlatformProcess::Sleep(TelemetryFlushInterval);
+	}
+
+	// Write whatever was queued before shutdown
+	Flush();
+	File.Reset();
+	return 0;
+}
+
+void FGameplayTelemetryWriter::Stop()
+{
+	bStopping = true;
+}
+
+void FGameplayTelemetryWriter::Flush()
+{
+	RowBuffer.Reset();
+
+	FGameplayTelemetrySample Sample;
+	while (Samples.Dequeue(Sample))
+	{
+		Sample.AppendCsvRow(RowBuffer);
+	}
+	if (RowBuffer.IsEmpty()) return;
+
+	if (!File.IsValid())
+	{
+		OpenNewFile();
+		if (!File.IsValid()) return;
+	}
+
+	FTCHARToUTF8 Utf8Rows(*RowBuffer);
+	File->Serialize(const_cast<ANSICHAR*>(Utf8Rows.Get()), Utf8Rows.Length());
+	File->Flush();
+
+	if (File->Tell() >= MaxFileSize)
+	{
+		File.Reset();
+	}
+}
+
+void FGameplayTelemetryWriter::OpenNewFile()
+{
+	DeleteOldFiles();
+
+	const FString FileName{ FString::Printf(TEXT("%s%s.csv"),
+		TelemetryFilePrefix,
+		*FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S_%s"))) };
+	File.Reset(IFileManager::Get().CreateFileWriter(*FPaths::Combine(Directory, FileName)));
+	if (!File.IsValid()) return;
+
+	FTCHARToUTF8 Utf8Header(FGameplayTelemetrySample::GetCsvHeader());
+	File->Serialize(const_cast<ANSICHAR*>(Utf8Header.Get()), Utf8Header.Length());
+}
+
+void FGameplayTelemetryWriter::DeleteOldFiles()
+{
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(Directory, FString(TelemetryFilePrefix) + TEXT("*.csv")), true, false);
+
+	// Names sort by creation time; leave room for the file about to be opened
+	FileNames.Sort();
+	for (int32 Index = 0; Index <= FileNames.Num() - MaxFiles; ++Index)
+	{
+		IFileManager::Get().Delete(*FPaths::Combine(Directory, FileNames[Index]));
+	}
+}
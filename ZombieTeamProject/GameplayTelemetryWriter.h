@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/CircularQueue.h"
+#include "GameplayTelemetry.h"
+
+/**
+ * Background thread that drains telemetry samples from a lock-free
+ * single-producer ring buffer into CSV files, starting a new file once the
+ * current one reaches MaxFileSize and keeping at most MaxFiles of them.
+ */
+class FGameplayTelemetryWriter : public FRunnable
+{
+public:
+	FGameplayTelemetryWriter(const FString& InDirectory, int64 InMaxFileSize, int32 InMaxFiles);
+	virtual ~FGameplayTelemetryWriter();
+
+	/** Game thread only; returns false and drops the sample when the buffer is full */
+	bool Enqueue(const FGameplayTelemetrySample& Sample);
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	void Flush();
+	void OpenNewFile();
+	void DeleteOldFiles();
+
+	TCircularQueue<FGameplayTelemetrySample> Samples;
+
+	FString Directory;
+	int64 MaxFileSize;
+	int32 MaxFiles;
+
+	/** Only touched by the writer thread */
+	TUniquePtr<FArchive> File;
+	FString RowBuffer;
+
+	FThreadSafeBool bStopping;
+	FRunnableThread* Thread;
+};
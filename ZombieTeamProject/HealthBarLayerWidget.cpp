@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HealthBarLayerWidget.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Rendering/DrawElements.h"
+#include "HealthBarSubsystem.h"
+#include "Enemy.h"
+#include "ZombieTeamProject.h"
+
+UHealthBarLayerWidget::UHealthBarLayerWidget(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer),
+	BackgroundColor(FLinearColor(0.f, 0.f, 0.f, 0.6f)),
+	FillColor(FLinearColor(0.8f, 0.05f, 0.05f, 1.f)),
+	BarSize(FVector2D(80.f, 8.f)),
+	BarHeightOffset(30.f),
+	MaxDrawDistance(3000.f)
+{
+	SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+int32 UHealthBarLayerWidget::NativePaint(
+	const FPaintArgs& Args,
+	const FGeometry& AllottedGeometry,
+	const FSlateRect& MyCullingRect,
+	FSlateWindowElementList& OutDrawElements,
+	int32 LayerId,
+	const FWidgetStyle& InWidgetStyle,
+	bool bParentEnabled) const
+{
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_HealthBarPaint);
+
+	LayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+	APlayerController* PlayerController = GetOwningPlayer();
+	UHealthBarSubsystem* HealthBars = GetWorld() ? GetWorld()->GetSubsystem<UHealthBarSubsystem>() : nullptr;
+	if (PlayerController == nullptr || PlayerController->PlayerCameraManager == nullptr || HealthBars == nullptr)
+	{
+		return LayerId;
+	}
+
+	HealthBars->RemoveExpiredBars();
+
+	const FVector CameraLocation{ PlayerController->PlayerCameraManager->GetCameraLocation() };
+	const float MaxDrawDistanceSquared{ FMath::Square(MaxDrawDistance) };
+	const FVector2D LayerSize{ AllottedGeometry.GetLocalSize() };
+	const FVector2D HalfBarSize{ BarSize * 0.5f };
+
+	// Backgrounds first, then fills, so each pass shares one brush and batches together
+	TArray<TPair<FVector2D, float>, TInlineAllocator<32>> VisibleBars;
+	for (const FHealthBarEntry& Entry : HealthBars->GetHealthBars())
+	{
+		const AEnemy* Enemy = Entry.Enemy.Get();
+		if (Enemy == nullptr) continue;
+
+		const FVector BarLocation{ Enemy->GetActorLocation() +
+			FVector(0.f, 0.f, Enemy->GetSimpleCollisionHalfHeight() + BarHeightOffset) };
+		if (FVector::DistSquared(CameraLocation, BarLocation) > MaxDrawDistanceSquared) continue;
+
+		FVector2D ScreenPosition;
+		if (!UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(PlayerController, BarLocation, ScreenPosition, true))
+		{
+			continue;
+		}
+
+		const FVector2D BarTopLeft{ ScreenPosition - HalfBarSize };
+		if (BarTopLeft.X + BarSize.X < 0.f || BarTopLeft.Y + BarSize.Y < 0.f ||
+			BarTopLeft.X > LayerSize.X || BarTopLeft.Y > LayerSize.Y)
+		{
+			continue;
+		}
+
+		VisibleBars.Emplace(BarTopLeft, FMath::Clamp(Entry.HealthFraction, 0.f, 1.f));
+	}
+
+	for (const TPair<FVector2D, float>& Bar : VisibleBars)
+	{
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(Bar.Key, BarSize),
+			&BarBrush,
+			ESlateDrawEffect::None,
+			BackgroundColor * InWidgetStyle.GetColorAndOpacityTint());
+	}
+	for (const TPair<FVector2D, float>& Bar : VisibleBars)
+	{
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId + 1,
+			AllottedGeometry.ToPaintGeometry(Bar.Key, FVector2D(BarSize.X * Bar.Value, BarSize.Y)),
+			&BarBrush,
+			ESlateDrawEffect::None,
+			FillColor * InWidgetStyle.GetColorAndOpacityTint());
+	}
+
+	return LayerId + 1;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HealthBarLayerWidget.generated.h"
+
+/**
+ * Full-screen layer that paints every enemy health bar from
+ * UHealthBarSubsystem in one pass, skipping bars that are too far away or
+ * off screen.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UHealthBarLayerWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	UHealthBarLayerWidget(const FObjectInitializer& ObjectInitializer);
+
+protected:
+	virtual int32 NativePaint(
+		const FPaintArgs& Args,
+		const FGeometry& AllottedGeometry,
+		const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements,
+		int32 LayerId,
+		const FWidgetStyle& InWidgetStyle,
+		bool bParentEnabled) const override;
+
+private:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HealthBar, meta = (AllowPrivateAccess = "true"))
+	FSlateBrush BarBrush;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HealthBar, meta = (AllowPrivateAccess = "true"))
+	FLinearColor BackgroundColor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HealthBar, meta = (AllowPrivateAccess = "true"))
+	FLinearColor FillColor;
+
+	/** Bar size in slate units */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HealthBar, meta = (AllowPrivateAccess = "true"))
+	FVector2D BarSize;
+
+	/** Height of the bar above the top of the enemy's capsule */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HealthBar, meta = (AllowPrivateAccess = "true"))
+	float BarHeightOffset;
+
+	/** Bars of enemies farther than this from the camera are not drawn */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = HealthBar, meta = (AllowPrivateAccess = "true"))
+	float MaxDrawDistance;
+};
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HealthBarSubsystem.h"
+#include "Enemy.h"
+
+FHealthBarEntry* UHealthBarSubsystem::FindHealthBar(const AEnemy* Enemy)
+{
+	return HealthBars.FindByPredicate([Enemy](const FHealthBarEntry& Entry)
+	{
+		return Entry.Enemy.Get() == Enemy;
+	});
+}
+
+void UHealthBarSubsystem::ShowHealthBar(AEnemy* Enemy, float HealthFraction, float DisplayTime)
+{
+	if (Enemy == nullptr) return;
+
+	const float ExpiryTime{ GetWorld()->GetTimeSeconds() + DisplayTime };
+	if (FHealthBarEntry* Entry = FindHealthBar(Enemy))
+	{
+		Entry->HealthFraction = HealthFraction;
+		Entry->ExpiryTime = ExpiryTime;
+		return;
+	}
+
+	RemoveExpiredBars();
+	HealthBars.Add({ Enemy, HealthFraction, ExpiryTime });
+}
+
+void UHealthBarSubsystem::HideHealthBar(AEnemy* Enemy)
+{
+	const int32 Index{ HealthBars.IndexOfByPredicate([Enemy](const FHealthBarEntry& Entry)
+	{
+		return Entry.Enemy.Get() == Enemy;
+	}) };
+	if (Index != INDEX_NONE)
+	{
+		HealthBars.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void UHealthBarSubsystem::SetHealthFraction(AEnemy* Enemy, float HealthFraction)
+{
+	if (FHealthBarEntry* Entry = FindHealthBar(Enemy))
+	{
+		Entry->HealthFraction = HealthFraction;
+	}
+}
+
+void UHealthBarSubsystem::RemoveExpiredBars()
+{
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	HealthBars.RemoveAllSwap([Now](const FHealthBarEntry& Entry)
+	{
+		return !Entry.Enemy.IsValid() || Entry.ExpiryTime <= Now;
+	}, false);
+}
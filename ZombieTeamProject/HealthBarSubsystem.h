@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HealthBarSubsystem.generated.h"
+
+/** One visible enemy health bar */
+struct FHealthBarEntry
+{
+	TWeakObjectPtr<class AEnemy> Enemy;
+	float HealthFraction;
+
+	/** World time at which the bar disappears */
+	float ExpiryTime;
+};
+
+/**
+ * Compact list of enemy health bars currently on screen. Enemies add and
+ * refresh their entries; UHealthBarLayerWidget draws all of them at once.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Show the enemy's bar for DisplayTime seconds, restarting the time if it is already shown */
+	void ShowHealthBar(AEnemy* Enemy, float HealthFraction, float DisplayTime);
+
+	void HideHealthBar(AEnemy* Enemy);
+
+	/** Update the fraction of a bar that is already shown */
+	void SetHealthFraction(AEnemy* Enemy, float HealthFraction);
+
+	/** Drop bars that expired or whose enemy is gone */
+	void RemoveExpiredBars();
+
+	FORCEINLINE const TArray<FHealthBarEntry>& GetHealthBars() const { return HealthBars; }
+
+private:
+	FHealthBarEntry* FindHealthBar(const AEnemy* Enemy);
+
+	TArray<FHealthBarEntry> HealthBars;
+};
@@ -0,0 +1,587 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitscanSubsystem.h"
+#include "Enemy.h"
+#include "Components/CapsuleComponent.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "Algo/Sort.h"
+#include "ZombieTeamProject.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+
+static TAutoConsoleVariable<int32> CVarLagCompensation(
+	TEXT("zombie.LagCompensation"),
+	1,
+	TEXT("Rewind enemy hit capsules to where remote players saw them when their shots are resolved on the server."));
+
+namespace
+{
+	/** Leaves hold at most this many capsules */
+	constexpr int32 MaxCapsulesPerLeaf{ 4 };
+
+	/** Snapshots closer together than this are skipped, so the history always spans MAX_REWIND_TIME */
+	constexpr float MinSnapshotInterval{ UHitscanSubsystem::MAX_REWIND_TIME / (UHitscanSubsystem::HISTORY_LENGTH - 1) };
+
+	/** World-space end points of a hit capsule on the enemy's current pose */
+	void GetCapsuleSegment(const AEnemy* Enemy, const FHitscanCapsuleSource& Source, FVector& OutStart, FVector& OutEnd)
+	{
+		if (Source.StartBoneIndex != INDEX_NONE)
+		{
+			const USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+			OutStart = Mesh->GetBoneTransform(Source.StartBoneIndex).TransformPosition(Source.LocalStart);
+			OutEnd = Mesh->GetBoneTransform(Source.EndBoneIndex).TransformPosition(Source.LocalEnd);
+		}
+		else
+		{
+			const UCapsuleComponent* CollisionCapsule = Enemy->GetCapsuleComponent();
+			const FVector Center{ CollisionCapsule->GetComponentLocation() };
+			const FVector HalfSegment{ CollisionCapsule->GetUpVector() * CollisionCapsule->GetScaledCapsuleHalfHeight_WithoutHemisphere() };
+			OutStart = Center - HalfSegment;
+			OutEnd = Center + HalfSegment;
+		}
+	}
+
+	FBox GetCapsuleBounds(const FHitscanCapsule& Capsule)
+	{
+		const FVector Extent{ Capsule.Radius };
+		return FBox(
+			Capsule.Start.ComponentMin(Capsule.End) - Extent,
+			Capsule.Start.ComponentMax(Capsule.End) + Extent);
+	}
+
+	bool IntersectRayBox(const FVector& Origin, const FVector& InvDirection, const FBox& Box, float MaxDistance)
+	{
+		float TMin{ 0.f };
+		float TMax{ MaxDistance };
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const float T1{ (Box.Min[Axis] - Origin[Axis]) * InvDirection[Axis] };
+			const float T2{ (Box.Max[Axis] - Origin[Axis]) * InvDirection[Axis] };
+			TMin = FMath::Max(TMin, FMath::Min(T1, T2));
+			TMax = FMath::Min(TMax, FMath::Max(T1, T2));
+		}
+		return TMin <= TMax;
+	}
+
+	/** Distance along a normalized ray to a sphere, negative on a miss */
+	float IntersectRaySphere(const FVector& Origin, const FVector& Direction, const FVector& Center, float Radius)
+	{
+		const FVector OC{ Origin - Center };
+		const float B{ Direction | OC };
+		const float C{ (OC | OC) - Radius * Radius };
+		const float H{ B * B - C };
+		return H < 0.f ? -1.f : -B - FMath::Sqrt(H);
+	}
+
+	/** Distance along a normalized ray to a capsule, zero if the ray starts inside it and negative on a miss */
+	float IntersectRayCapsule(const FVector& Origin, const FVector& Direction, const FHitscanCapsule& Capsule)
+	{
+		// Point-blank shots start inside the capsule; a physics trace reports those as initial overlaps
+		if (FMath::PointDistToSegmentSquared(Origin, Capsule.Start, Capsule.End) <= Capsule.Radius * Capsule.Radius) return 0.f;
+
+		const FVector BA{ Capsule.End - Capsule.Start };
+		const FVector OA{ Origin - Capsule.Start };
+		const float BABA{ BA | BA };
+		const float BARD{ BA | Direction };
+		const float BAOA{ BA | OA };
+
+		// Cylinder between the two end points
+		const float A{ BABA - BARD * BARD };
+		if (A > KINDA_SMALL_NUMBER)
+		{
+			const float B{ BABA * (Direction | OA) - BAOA * BARD };
+			const float C{ BABA * (OA | OA) - BAOA * BAOA - Capsule.Radius * Capsule.Radius * BABA };
+			const float H{ B * B - A * C };
+
+			// Missing the infinite cylinder means missing the whole capsule
+			if (H < 0.f) return -1.f;
+
+			const float T{ (-B - FMath::Sqrt(H)) / A };
+			const float Y{ BAOA + T * BARD };
+			if (Y > 0.f && Y < BABA) return T;
+		}
+
+		// Hemispherical caps
+		const float TStart{ IntersectRaySphere(Origin, Direction, Capsule.Start, Capsule.Radius) };
+		const float TEnd{ IntersectRaySphere(Origin, Direction, Capsule.End, Capsule.Radius) };
+		if (TStart < 0.f) return TEnd;
+		if (TEnd < 0.f) return TStart;
+		return FMath::Min(TStart, TEnd);
+	}
+
+	/** Report a capsule hit at Distance along the trace the way a physics trace against the enemy mesh would */
+	void AddEnemyHit(
+		TArray<FHitResult>& OutHits,
+		AEnemy* Enemy,
+		const FHitscanCapsuleSource& Source,
+		const FHitscanCapsule& Capsule,
+		const FVector& Start,
+		const FVector& End,
+		const FVector& Direction,
+		float Distance,
+		float MaxDistance)
+	{
+		const FVector Location{ Start + Direction * Distance };
+		const FVector AxisPoint{ FMath::ClosestPointOnSegment(Location, Capsule.Start, Capsule.End) };
+		const FVector AxisOffset{ Location - AxisPoint };
+		const FVector Normal{ AxisOffset.IsNearlyZero() ? -Direction : AxisOffset.GetSafeNormal() };
+
+		FHitResult& Hit = OutHits.Emplace_GetRef(Enemy, Enemy->GetMesh(), Location, Normal);
+		Hit.bBlockingHit = false;
+		Hit.TraceStart = Start;
+		Hit.TraceEnd = End;
+		Hit.Distance = Distance;
+		Hit.Time = Distance / MaxDistance;
+		Hit.BoneName = Source.BoneName;
+		Hit.Item = Source.BodyIndex;
+	}
+}
+
+void UHitscanSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr) return;
+
+	FHitscanEnemy& Entry = Enemies.AddDefaulted_GetRef();
+	Entry.Enemy = Enemy;
+
+	USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+	for (const FHitCapsule& HitCapsule : Enemy->GetHitCapsules())
+	{
+		const int32 StartBoneIndex{ Mesh->GetBoneIndex(HitCapsule.StartBone) };
+		if (StartBoneIndex == INDEX_NONE) continue;
+
+		const int32 EndBoneIndex{ HitCapsule.EndBone.IsNone() ? StartBoneIndex : Mesh->GetBoneIndex(HitCapsule.EndBone) };
+
+		FHitscanCapsuleSource& Source = Entry.Sources.AddDefaulted_GetRef();
+		Source.StartBoneIndex = StartBoneIndex;
+		Source.EndBoneIndex = EndBoneIndex == INDEX_NONE ? StartBoneIndex : EndBoneIndex;
+		Source.LocalStart = FVector::ZeroVector;
+		Source.LocalEnd = FVector::ZeroVector;
+		Source.Radius = HitCapsule.Radius;
+		Source.BoneName = HitCapsule.StartBone;
+		Source.BodyIndex = Enemy->FindHitBodyIndex(HitCapsule.StartBone);
+	}
+
+	// Without authored capsules the physics bodies give the same hit zones as physics traces
+	if (Entry.Sources.Num() == 0)
+	{
+		AddPhysicsAssetSources(Entry, Enemy);
+	}
+
+	// Enemies without hit capsules or physics bodies are hit through their collision capsule
+	if (Entry.Sources.Num() == 0)
+	{
+		FHitscanCapsuleSource& Source = Entry.Sources.AddDefaulted_GetRef();
+		Source.StartBoneIndex = INDEX_NONE;
+		Source.EndBoneIndex = INDEX_NONE;
+		Source.LocalStart = FVector::ZeroVector;
+		Source.LocalEnd = FVector::ZeroVector;
+		Source.Radius = Enemy->GetCapsuleComponent()->GetScaledCapsuleRadius();
+		Source.BoneName = NAME_None;
+		Source.BodyIndex = INDEX_NONE;
+	}
+
+	LastUpdateFrame = MAX_uint64;
+}
+
+void UHitscanSubsystem::AddPhysicsAssetSources(FHitscanEnemy& Entry, const AEnemy* Enemy) const
+{
+	const USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+	const UPhysicsAsset* PhysicsAsset = Mesh->GetPhysicsAsset();
+	if (PhysicsAsset == nullptr) return;
+
+	// Bone transforms carry the component scale for the end points, but not for the radius
+	const float RadiusScale{ Mesh->GetComponentScale().GetAbsMax() };
+
+	for (int32 BodyIndex = 0; BodyIndex < PhysicsAsset->SkeletalBodySetups.Num(); ++BodyIndex)
+	{
+		const USkeletalBodySetup* BodySetup = PhysicsAsset->SkeletalBodySetups[BodyIndex];
+		if (BodySetup == nullptr) continue;
+
+		const int32 BoneIndex{ Mesh->GetBoneIndex(BodySetup->BoneName) };
+		if (BoneIndex == INDEX_NONE) continue;
+
+		auto AddSource = [&Entry, BoneIndex, BodyIndex, BodySetup](const FVector& LocalStart, const FVector& LocalEnd, float Radius)
+		{
+			FHitscanCapsuleSource& Source = Entry.Sources.AddDefaulted_GetRef();
+			Source.StartBoneIndex = BoneIndex;
+			Source.EndBoneIndex = BoneIndex;
+			Source.LocalStart = LocalStart;
+			Source.LocalEnd = LocalEnd;
+			Source.Radius = Radius;
+			Source.BoneName = BodySetup->BoneName;
+			Source.BodyIndex = BodyIndex;
+		};
+
+		for (const FKSphylElem& Sphyl : BodySetup->AggGeom.SphylElems)
+		{
+			const FVector HalfSegment{ Sphyl.Rotation.RotateVector(FVector(0.f, 0.f, Sphyl.Length * 0.5f)) };
+			AddSource(Sphyl.Center - HalfSegment, Sphyl.Center + HalfSegment, Sphyl.Radius * RadiusScale);
+		}
+		for (const FKSphereElem& Sphere : BodySetup->AggGeom.SphereElems)
+		{
+			AddSource(Sphere.Center, Sphere.Center, Sphere.Radius * RadiusScale);
+		}
+	}
+}
+
+void UHitscanSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	for (int32 EnemyIndex = Enemies.Num() - 1; EnemyIndex >= 0; --EnemyIndex)
+	{
+		const FHitscanEnemy& Entry = Enemies[EnemyIndex];
+		if (Entry.Enemy.Get() != Enemy && Entry.Enemy.IsValid()) continue;
+
+		if (Entry.HistorySlot != INDEX_NONE)
+		{
+			FreeHistorySlots.Add(Entry.HistorySlot);
+		}
+		Enemies.RemoveAtSwap(EnemyIndex, 1, false);
+	}
+
+	LastUpdateFrame = MAX_uint64;
+}
+
+void UHitscanSubsystem::UpdateCapsules()
+{
+	if (LastUpdateFrame == GFrameCounter) return;
+	LastUpdateFrame = GFrameCounter;
+
+	Capsules.Reset();
+	for (int32 EnemyIndex = 0; EnemyIndex < Enemies.Num(); ++EnemyIndex)
+	{
+		const FHitscanEnemy& Entry = Enemies[EnemyIndex];
+		const AEnemy* Enemy = Entry.Enemy.Get();
+		if (Enemy == nullptr) continue;
+
+		for (int32 SourceIndex = 0; SourceIndex < Entry.Sources.Num(); ++SourceIndex)
+		{
+			const FHitscanCapsuleSource& Source = Entry.Sources[SourceIndex];
+
+			FHitscanCapsule& Capsule = Capsules.AddUninitialized_GetRef();
+			Capsule.Radius = Source.Radius;
+			Capsule.EnemyIndex = EnemyIndex;
+			Capsule.SourceIndex = SourceIndex;
+			GetCapsuleSegment(Enemy, Source, Capsule.Start, Capsule.End);
+		}
+	}
+
+	Nodes.Reset();
+	if (Capsules.Num() == 0) return;
+
+	Nodes.Reserve(Capsules.Num() * 2);
+	Nodes.AddUninitialized();
+	BuildNode(0, 0, Capsules.Num());
+}
+
+void UHitscanSubsystem::BuildNode(int32 NodeIndex, int32 First, int32 Num)
+{
+	FBox Bounds(ForceInit);
+	FBox CentroidBounds(ForceInit);
+	for (int32 Index = First; Index < First + Num; ++Index)
+	{
+		const FHitscanCapsule& Capsule = Capsules[Index];
+		Bounds += GetCapsuleBounds(Capsule);
+		CentroidBounds += (Capsule.Start + Capsule.End) * 0.5f;
+	}
+
+	Nodes[NodeIndex].Bounds = Bounds;
+
+	if (Num <= MaxCapsulesPerLeaf)
+	{
+		Nodes[NodeIndex].FirstIndex = First;
+		Nodes[NodeIndex].NumCapsules = Num;
+		return;
+	}
+
+	// Median split along the axis where the capsule centers are most spread out
+	const FVector Extent{ CentroidBounds.GetExtent() };
+	const int32 Axis{ Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2) };
+	Algo::Sort(MakeArrayView(Capsules.GetData() + First, Num), [Axis](const FHitscanCapsule& A, const FHitscanCapsule& B)
+	{
+		return (A.Start[Axis] + A.End[Axis]) < (B.Start[Axis] + B.End[Axis]);
+	});
+
+	const int32 LeftIndex{ Nodes.AddUninitialized(2) };
+	Nodes[NodeIndex].FirstIndex = LeftIndex;
+	Nodes[NodeIndex].NumCapsules = 0;
+
+	const int32 NumLeft{ Num / 2 };
+	BuildNode(LeftIndex, First, NumLeft);
+	BuildNode(LeftIndex + 1, First + NumLeft, Num - NumLeft);
+}
+
+void UHitscanSubsystem::LineTraceEnemies(const FVector& Start, const FVector& End, TArray<FHitResult>& OutHits)
+{
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_HitscanEnemyTrace);
+	INC_DWORD_STAT(STAT_ZombieTraces);
+
+	OutHits.Reset();
+
+	UpdateCapsules();
+	if (Nodes.Num() == 0) return;
+
+	FVector Direction;
+	float MaxDistance;
+	(End - Start).ToDirectionAndLength(Direction, MaxDistance);
+	if (MaxDistance <= KINDA_SMALL_NUMBER) return;
+
+	const FVector InvDirection{
+		FMath::IsNearlyZero(Direction.X) ? BIG_NUMBER : 1.f / Direction.X,
+		FMath::IsNearlyZero(Direction.Y) ? BIG_NUMBER : 1.f / Direction.Y,
+		FMath::IsNearlyZero(Direction.Z) ? BIG_NUMBER : 1.f / Direction.Z };
+
+	struct FCapsuleHit
+	{
+		float Distance;
+		int32 CapsuleIndex;
+	};
+	TArray<FCapsuleHit, TInlineAllocator<16>> CapsuleHits;
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Push(0);
+	while (Stack.Num() > 0)
+	{
+		const FHitscanBVHNode& Node = Nodes[Stack.Pop(false)];
+		if (!IntersectRayBox(Start, InvDirection, Node.Bounds, MaxDistance)) continue;
+
+		if (Node.NumCapsules == 0)
+		{
+			Stack.Push(Node.FirstIndex);
+			Stack.Push(Node.FirstIndex + 1);
+			continue;
+		}
+
+		for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumCapsules; ++Index)
+		{
+			const float Distance{ IntersectRayCapsule(Start, Direction, Capsules[Index]) };
+			if (Distance >= 0.f && Distance <= MaxDistance)
+			{
+				CapsuleHits.Add({ Distance, Index });
+			}
+		}
+	}
+
+	CapsuleHits.Sort([](const FCapsuleHit& A, const FCapsuleHit& B) { return A.Distance < B.Distance; });
+
+	TArray<int32, TInlineAllocator<16>> HitEnemies;
+	for (const FCapsuleHit& CapsuleHit : CapsuleHits)
+	{
+		const FHitscanCapsule& Capsule = Capsules[CapsuleHit.CapsuleIndex];
+		if (HitEnemies.Contains(Capsule.EnemyIndex)) continue;
+		HitEnemies.Add(Capsule.EnemyIndex);
+
+		const FHitscanEnemy& Entry = Enemies[Capsule.EnemyIndex];
+		AddEnemyHit(OutHits, Entry.Enemy.Get(), Entry.Sources[Capsule.SourceIndex], Capsule, Start, End, Direction, CapsuleHit.Distance, MaxDistance);
+	}
+}
+
+bool UHitscanSubsystem::CanRewind() const
+{
+	return CVarLagCompensation.GetValueOnGameThread() != 0 && NumSnapshots > 0;
+}
+
+void UHitscanSubsystem::LineTraceEnemiesAtTime(const FVector& Start, const FVector& End, float Time, TArray<FHitResult>& OutHits)
+{
+	if (!CanRewind())
+	{
+		LineTraceEnemies(Start, End, OutHits);
+		return;
+	}
+
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_HitscanRewindTrace);
+	INC_DWORD_STAT(STAT_ZombieTraces);
+
+	OutHits.Reset();
+
+	FVector Direction;
+	float MaxDistance;
+	(End - Start).ToDirectionAndLength(Direction, MaxDistance);
+	if (MaxDistance <= KINDA_SMALL_NUMBER) return;
+
+	// Every enemy shares the ring positions, so the pair of snapshots around Time
+	// is found once for the whole trace. Times only decrease with age, so binary
+	// search for the newest snapshot taken at or before Time
+	auto GetSnapshotTime = [this](int32 Age) { return SnapshotTimes[(NewestSnapshot - Age + HISTORY_LENGTH) % HISTORY_LENGTH]; };
+	int32 FirstOlderAge{ 0 };
+	int32 SearchEnd{ NumSnapshots };
+	while (FirstOlderAge < SearchEnd)
+	{
+		const int32 MidAge{ (FirstOlderAge + SearchEnd) / 2 };
+		if (GetSnapshotTime(MidAge) > Time)
+		{
+			FirstOlderAge = MidAge + 1;
+		}
+		else
+		{
+			SearchEnd = MidAge;
+		}
+	}
+	const int32 NewerAge{ FMath::Clamp(FirstOlderAge - 1, 0, NumSnapshots - 1) };
+	const int32 OlderAge{ FMath::Min(NewerAge + 1, NumSnapshots - 1) };
+	const float NewerTime{ GetSnapshotTime(NewerAge) };
+	const float OlderTime{ GetSnapshotTime(OlderAge) };
+	const float Alpha{ NewerTime > OlderTime ? FMath::Clamp((Time - OlderTime) / (NewerTime - OlderTime), 0.f, 1.f) : 1.f };
+
+	struct FRewoundHit
+	{
+		float Distance;
+		int32 EnemyIndex;
+		int32 SourceIndex;
+		FHitscanCapsule Capsule;
+	};
+	TArray<FRewoundHit, TInlineAllocator<16>> RewoundHits;
+
+	for (int32 EnemyIndex = 0; EnemyIndex < Enemies.Num(); ++EnemyIndex)
+	{
+		const FHitscanEnemy& Entry = Enemies[EnemyIndex];
+		if (Entry.NumSnapshots == 0 || !Entry.Enemy.IsValid()) continue;
+
+		// Enemies registered after the rewind time are held at their first snapshot
+		const int32 EnemyNewerAge{ FMath::Min(NewerAge, Entry.NumSnapshots - 1) };
+		const int32 EnemyOlderAge{ FMath::Min(OlderAge, Entry.NumSnapshots - 1) };
+		const int32 Newer{ (NewestSnapshot - EnemyNewerAge + HISTORY_LENGTH) % HISTORY_LENGTH };
+		const int32 Older{ (NewestSnapshot - EnemyOlderAge + HISTORY_LENGTH) % HISTORY_LENGTH };
+
+		// Interpolated points stay within the larger of the two bounding spheres around the interpolated center
+		const int32 NewerSnapshot{ GetSnapshotIndex(Entry.HistorySlot, Newer) };
+		const int32 OlderSnapshot{ GetSnapshotIndex(Entry.HistorySlot, Older) };
+		const FVector BoundsCenter{ FMath::Lerp(HistoryBoundsCenters[OlderSnapshot], HistoryBoundsCenters[NewerSnapshot], Alpha) };
+		const float BoundsRadius{ FMath::Max(HistoryBoundsRadii[OlderSnapshot], HistoryBoundsRadii[NewerSnapshot]) };
+		if (FMath::PointDistToSegmentSquared(BoundsCenter, Start, End) > BoundsRadius * BoundsRadius) continue;
+
+		FRewoundHit NearestHit;
+		NearestHit.Distance = MaxDistance + 1.f;
+
+		const int32 NumHistorySources{ FMath::Min(Entry.Sources.Num(), MAX_HISTORY_CAPSULES) };
+		for (int32 SourceIndex = 0; SourceIndex < NumHistorySources; ++SourceIndex)
+		{
+			const int32 NewerCapsule{ GetHistoryCapsuleIndex(Entry.HistorySlot, Newer, SourceIndex) };
+			const int32 OlderCapsule{ GetHistoryCapsuleIndex(Entry.HistorySlot, Older, SourceIndex) };
+
+			FHitscanCapsule Capsule;
+			Capsule.Start = FMath::Lerp(HistoryCapsuleStarts[OlderCapsule], HistoryCapsuleStarts[NewerCapsule], Alpha);
+			Capsule.End = FMath::Lerp(HistoryCapsuleEnds[OlderCapsule], HistoryCapsuleEnds[NewerCapsule], Alpha);
+			Capsule.Radius = Entry.Sources[SourceIndex].Radius;
+			Capsule.EnemyIndex = EnemyIndex;
+			Capsule.SourceIndex = SourceIndex;
+
+			const float Distance{ IntersectRayCapsule(Start, Direction, Capsule) };
+			if (Distance >= 0.f && Distance < NearestHit.Distance)
+			{
+				NearestHit.Distance = Distance;
+				NearestHit.EnemyIndex = EnemyIndex;
+				NearestHit.SourceIndex = SourceIndex;
+				NearestHit.Capsule = Capsule;
+			}
+		}
+
+		if (NearestHit.Distance <= MaxDistance)
+		{
+			RewoundHits.Add(NearestHit);
+		}
+	}
+
+	RewoundHits.Sort([](const FRewoundHit& A, const FRewoundHit& B) { return A.Distance < B.Distance; });
+
+	for (const FRewoundHit& RewoundHit : RewoundHits)
+	{
+		const FHitscanEnemy& Entry = Enemies[RewoundHit.EnemyIndex];
+		AddEnemyHit(OutHits, Entry.Enemy.Get(), Entry.Sources[RewoundHit.SourceIndex], RewoundHit.Capsule, Start, End, Direction, RewoundHit.Distance, MaxDistance);
+	}
+}
+
+int32 UHitscanSubsystem::AllocateHistorySlot()
+{
+	if (FreeHistorySlots.Num() > 0)
+	{
+		return FreeHistorySlots.Pop(false);
+	}
+
+	const int32 HistorySlot{ HistoryBoundsRadii.Num() / HISTORY_LENGTH };
+	HistoryCapsuleStarts.AddUninitialized(HISTORY_LENGTH * MAX_HISTORY_CAPSULES);
+	HistoryCapsuleEnds.AddUninitialized(HISTORY_LENGTH * MAX_HISTORY_CAPSULES);
+	HistoryBoundsCenters.AddUninitialized(HISTORY_LENGTH);
+	HistoryBoundsRadii.AddUninitialized(HISTORY_LENGTH);
+	return HistorySlot;
+}
+
+void UHitscanSubsystem::RecordSnapshot(float Time)
+{
+	NewestSnapshot = (NewestSnapshot + 1) % HISTORY_LENGTH;
+	NumSnapshots = FMath::Min(NumSnapshots + 1, HISTORY_LENGTH);
+	SnapshotTimes[NewestSnapshot] = Time;
+
+	for (FHitscanEnemy& Entry : Enemies)
+	{
+		const AEnemy* Enemy = Entry.Enemy.Get();
+		if (Enemy == nullptr) continue;
+
+		if (Entry.HistorySlot == INDEX_NONE)
+		{
+			Entry.HistorySlot = AllocateHistorySlot();
+		}
+		Entry.NumSnapshots = FMath::Min(Entry.NumSnapshots + 1, HISTORY_LENGTH);
+
+		FBox Bounds(ForceInit);
+		float MaxRadius{ 0.f };
+		const int32 NumHistorySources{ FMath::Min(Entry.Sources.Num(), MAX_HISTORY_CAPSULES) };
+		for (int32 SourceIndex = 0; SourceIndex < NumHistorySources; ++SourceIndex)
+		{
+			const int32 CapsuleIndex{ GetHistoryCapsuleIndex(Entry.HistorySlot, NewestSnapshot, SourceIndex) };
+			FVector& CapsuleStart = HistoryCapsuleStarts[CapsuleIndex];
+			FVector& CapsuleEnd = HistoryCapsuleEnds[CapsuleIndex];
+			GetCapsuleSegment(Enemy, Entry.Sources[SourceIndex], CapsuleStart, CapsuleEnd);
+
+			Bounds += CapsuleStart;
+			Bounds += CapsuleEnd;
+			MaxRadius = FMath::Max(MaxRadius, Entry.Sources[SourceIndex].Radius);
+		}
+
+		const int32 SnapshotIndex{ GetSnapshotIndex(Entry.HistorySlot, NewestSnapshot) };
+		HistoryBoundsCenters[SnapshotIndex] = Bounds.GetCenter();
+		HistoryBoundsRadii[SnapshotIndex] = Bounds.GetExtent().Size() + MaxRadius;
+	}
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	const float Now{ GetWorld()->GetTimeSeconds() };
+	if (NumSnapshots > 0 && Now - SnapshotTimes[NewestSnapshot] < MinSnapshotInterval) return;
+
+	// Recording paused while no client was connected; what is left is too old to rewind into
+	if (NumSnapshots > 0 && Now - SnapshotTimes[NewestSnapshot] > MAX_REWIND_TIME)
+	{
+		NumSnapshots = 0;
+		for (FHitscanEnemy& Entry : Enemies)
+		{
+			Entry.NumSnapshots = 0;
+		}
+	}
+
+	RecordSnapshot(Now);
+}
+
+ETickableTickType UHitscanSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UHitscanSubsystem::IsTickable() const
+{
+	// Only servers resolve shots from players who saw the world late, and only while one is connected
+	const UWorld* World = GetWorld();
+	const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	return World && World->IsGameWorld()
+		&& (World->GetNetMode() == NM_DedicatedServer || World->GetNetMode() == NM_ListenServer)
+		&& NetDriver && NetDriver->ClientConnections.Num() > 0
+		&& CVarLagCompensation.GetValueOnGameThread() != 0
+		&& Enemies.Num() > 0;
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
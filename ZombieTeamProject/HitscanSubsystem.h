@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "HitscanSubsystem.generated.h"
+
+/** Where one enemy hit capsule reads its transform from every frame */
+struct FHitscanCapsuleSource
+{
+	/** Mesh bone indices of the capsule end points, INDEX_NONE to use the collision capsule */
+	int32 StartBoneIndex;
+	int32 EndBoneIndex;
+
+	/** End points in the space of their bones; zero for capsules running bone to bone */
+	FVector LocalStart;
+	FVector LocalEnd;
+
+	float Radius;
+
+	/** Physics body reported in FHitResult::Item so hit zones resolve as for physics traces */
+	int32 BodyIndex;
+	FName BoneName;
+};
+
+/** World-space hit capsule refreshed once per frame */
+struct FHitscanCapsule
+{
+	FVector Start;
+	FVector End;
+	float Radius;
+	int32 EnemyIndex;
+	int32 SourceIndex;
+};
+
+struct FHitscanBVHNode
+{
+	FBox Bounds;
+
+	/** Left child for inner nodes (right child follows it), first capsule for leaves */
+	int32 FirstIndex;
+
+	/** Number of capsules in a leaf, zero for inner nodes */
+	int32 NumCapsules;
+};
+
+/**
+ * Dedicated hitscan structure for bullets against enemies. Every registered
+ * enemy contributes a few hit capsules driven by its bones; a BVH over those
+ * capsules is rebuilt at most once per frame, the first time it is queried.
+ *
+ * On a server with remote players the capsules are also snapshotted every
+ * tick into a short history, so shots from lagged clients can be tested
+ * against where the enemies were when the client saw them.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UHitscanSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Snapshots kept per enemy; at the minimum interval this covers MAX_REWIND_TIME */
+	static constexpr int32 HISTORY_LENGTH{ 32 };
+
+	/** Capsules recorded per enemy snapshot; rewound traces ignore any beyond this */
+	static constexpr int32 MAX_HISTORY_CAPSULES{ 24 };
+
+	/** How far back a shot can be rewound, in seconds */
+	static constexpr float MAX_REWIND_TIME{ 0.5f };
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(class AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	/**
+	 * Find every enemy whose hit capsules the segment crosses. Only the nearest
+	 * capsule of each enemy is reported; results are sorted by distance and
+	 * point at the enemy mesh, with bone name and body index filled in.
+	 */
+	void LineTraceEnemies(const FVector& Start, const FVector& End, TArray<FHitResult>& OutHits);
+
+	/**
+	 * LineTraceEnemies against the capsules as they were at world time Time,
+	 * interpolated between the two snapshots around it. Actors are not moved,
+	 * so any number of rewound traces can run in one frame.
+	 */
+	void LineTraceEnemiesAtTime(const FVector& Start, const FVector& End, float Time, TArray<FHitResult>& OutHits);
+
+	/** Whether shots can be rewound: lag compensation is on and history has been recorded */
+	bool CanRewind() const;
+
+	FORCEINLINE int32 GetNumRegisteredEnemies() const { return Enemies.Num(); }
+
+private:
+	struct FHitscanEnemy
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		TArray<FHitscanCapsuleSource, TInlineAllocator<12>> Sources;
+
+		/** Block of the history pool owned by this enemy, allocated on its first snapshot */
+		int32 HistorySlot{ INDEX_NONE };
+
+		/** Snapshots recorded since the enemy registered, up to HISTORY_LENGTH */
+		int32 NumSnapshots{ 0 };
+	};
+
+	/** Capsules from the sphyl and sphere bodies of the enemy's physics asset, for enemies without authored ones */
+	void AddPhysicsAssetSources(FHitscanEnemy& Entry, const AEnemy* Enemy) const;
+
+	/** Refresh capsule transforms and rebuild the BVH if that has not happened this frame */
+	void UpdateCapsules();
+
+	void BuildNode(int32 NodeIndex, int32 First, int32 Num);
+
+	/** Write every enemy's current capsules into the next history snapshot */
+	void RecordSnapshot(float Time);
+
+	int32 AllocateHistorySlot();
+
+	/** Index of an enemy snapshot in the per-snapshot history arrays */
+	FORCEINLINE static int32 GetSnapshotIndex(int32 HistorySlot, int32 Snapshot) { return HistorySlot * HISTORY_LENGTH + Snapshot; }
+
+	/** Index of a capsule in the per-capsule history arrays */
+	FORCEINLINE static int32 GetHistoryCapsuleIndex(int32 HistorySlot, int32 Snapshot, int32 SourceIndex) { return GetSnapshotIndex(HistorySlot, Snapshot) * MAX_HISTORY_CAPSULES + SourceIndex; }
+
+	TArray<FHitscanEnemy> Enemies;
+
+	/** Capsules in BVH leaf order */
+	TArray<FHitscanCapsule> Capsules;
+	TArray<FHitscanBVHNode> Nodes;
+
+	uint64 LastUpdateFrame{ MAX_uint64 };
+
+	/**
+	 * History pool, one fixed-size ring block per enemy slot. The components
+	 * are kept in separate arrays so a rewind only touches the bounds of enemies
+	 * it misses and the end points of the ones it might hit.
+	 */
+	TArray<FVector> HistoryCapsuleStarts;
+	TArray<FVector> HistoryCapsuleEnds;
+	TArray<FVector> HistoryBoundsCenters;
+	TArray<float> HistoryBoundsRadii;
+	TArray<int32> FreeHistorySlots;
+
+	/** World time of each snapshot; every enemy is recorded into the same ring position */
+	float SnapshotTimes[HISTORY_LENGTH];
+	int32 NewestSnapshot{ INDEX_NONE };
+	int32 NumSnapshots{ 0 };
+};
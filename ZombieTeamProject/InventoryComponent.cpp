@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InventoryComponent.h"
+#include "Item.h"
+#include "Net/UnrealNetwork.h"
+
+FInventoryItemOwnerChanged UInventoryComponent::NotifyItemOwnerChanged;
+
+// Sets default values for this component's properties
+UInventoryComponent::UInventoryComponent() :
+	ActiveSlot(0),
+	NumItems(0)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+
+	for (AItem*& Slot : Slots)
+	{
+		Slot = nullptr;
+	}
+	for (int32& AmmoCount : AmmoCounts)
+	{
+		AmmoCount = 0;
+	}
+	for (int32& Ammo : StartingAmmo)
+	{
+		Ammo = 0;
+	}
+	StartingAmmo[static_cast<uint8>(EAmmoType::EAT_9mm)] = 85;
+	StartingAmmo[static_cast<uint8>(EAmmoType::EAT_AR)] = 120;
+}
+
+// Called when the game starts
+void UInventoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Clients may already hold replicated counts by now
+	const bool bAuthority{ GetOwnerRole() == ROLE_Authority };
+	for (uint8 AmmoIndex = 0; AmmoIndex < static_cast<uint8>(EAmmoType::EAT_MAX); ++AmmoIndex)
+	{
+		if (bAuthority)
+		{
+			AmmoCounts[AmmoIndex] = StartingAmmo[AmmoIndex];
+		}
+		OnAmmoChanged.Broadcast(static_cast<EAmmoType>(AmmoIndex), AmmoCounts[AmmoIndex]);
+	}
+}
+
+void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Other players see the equipped weapon on the character instead
+	DOREPLIFETIME_CONDITION(UInventoryComponent, Slots, COND_ReplayOrOwner);
+	DOREPLIFETIME_CONDITION(UInventoryComponent, AmmoCounts, COND_ReplayOrOwner);
+	DOREPLIFETIME_CONDITION(UInventoryComponent, ActiveSlot, COND_ReplayOrOwner);
+}
+
+void UInventoryComponent::OnRep_Slots()
+{
+	NumItems = 0;
+	for (int32 SlotIndex = 0; SlotIndex < INVENTORY_CAPACITY; ++SlotIndex)
+	{
+		NumItems += Slots[SlotIndex] != nullptr;
+		OnSlotChanged.Broadcast(SlotIndex, Slots[SlotIndex]);
+	}
+}
+
+void UInventoryComponent::OnRep_AmmoCounts()
+{
+	for (uint8 AmmoIndex = 0; AmmoIndex < static_cast<uint8>(EAmmoType::EAT_MAX); ++AmmoIndex)
+	{
+		OnAmmoChanged.Broadcast(static_cast<EAmmoType>(AmmoIndex), AmmoCounts[AmmoIndex]);
+	}
+}
+
+void UInventoryComponent::OnRep_ActiveSlot(int32 PreviousActiveSlot)
+{
+	OnActiveSlotChanged.Broadcast(PreviousActiveSlot, ActiveSlot);
+}
+
+int32 UInventoryComponent::AddItem(AItem* Item)
+{
+	if (Item == nullptr) return INDEX_NONE;
+
+	for (int32 SlotIndex = 0; SlotIndex < INVENTORY_CAPACITY; ++SlotIndex)
+	{
+		if (Slots[SlotIndex] == nullptr)
+		{
+			SetItemAt(SlotIndex, Item);
+			return SlotIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+AItem* UInventoryComponent::SetItemAt(int32 SlotIndex, AItem* Item)
+{
+	if (SlotIndex < 0 || SlotIndex >= INVENTORY_CAPACITY) return nullptr;
+
+	AItem* PreviousItem = Slots[SlotIndex];
+	if (PreviousItem == Item) return PreviousItem;
+
+	NumItems += (Item != nullptr) - (PreviousItem != nullptr);
+	Slots[SlotIndex] = Item;
+	if (PreviousItem && PreviousItem->GetOwner() == GetOwner())
+	{
+		PreviousItem->SetOwner(nullptr);
+		NotifyItemOwnerChanged.Broadcast(PreviousItem, nullptr);
+	}
+	if (Item)
+	{
+		// Owner-only properties such as weapon ammo follow the item's owner
+		Item->SetOwner(GetOwner());
+		Item->SetSlotIndex(SlotIndex);
+		NotifyItemOwnerChanged.Broadcast(Item, GetOwner());
+	}
+
+	OnSlotChanged.Broadcast(SlotIndex, Item);
+	return PreviousItem;
+}
+
+AItem* UInventoryComponent::GetItemAt(int32 SlotIndex) const
+{
+	if (SlotIndex < 0 || SlotIndex >= INVENTORY_CAPACITY) return nullptr;
+
+	return Slots[SlotIndex];
+}
+
+bool UInventoryComponent::SelectSlot(int32 SlotIndex)
+{
+	if (SlotIndex == ActiveSlot || GetItemAt(SlotIndex) == nullptr) return false;
+
+	const int32 PreviousSlot{ ActiveSlot };
+	ActiveSlot = SlotIndex;
+	OnActiveSlotChanged.Broadcast(PreviousSlot, ActiveSlot);
+	return true;
+}
+
+int32 UInventoryComponent::GetAmmo(EAmmoType AmmoType) const
+{
+	if (AmmoType == EAmmoType::EAT_MAX) return 0;
+
+	return AmmoCounts[static_cast<uint8>(AmmoType)];
+}
+
+void UInventoryComponent::AddAmmo(EAmmoType AmmoType, int32 Amount)
+{
+	if (AmmoType == EAmmoType::EAT_MAX || Amount <= 0) return;
+
+	int32& AmmoCount = AmmoCounts[static_cast<uint8>(AmmoType)];
+	AmmoCount += Amount;
+	OnAmmoChanged.Broadcast(AmmoType, AmmoCount);
+}
+
+int32 UInventoryComponent::TakeAmmo(EAmmoType AmmoType, int32 Amount)
+{
+	if (AmmoType == EAmmoType::EAT_MAX || Amount <= 0) return 0;
+
+	int32& AmmoCount = AmmoCounts[static_cast<uint8>(AmmoType)];
+	const int32 Taken{ FMath::Min(Amount, AmmoCount) };
+	if (Taken > 0)
+	{
+		AmmoCount -= Taken;
+		OnAmmoChanged.Broadcast(AmmoType, AmmoCount);
+	}
+	return Taken;
+}
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "AmmoType.h"
+#include "InventoryComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventorySlotChangedSignature, int32, SlotIndex, class AItem*, Item);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryAmmoChangedSignature, EAmmoType, AmmoType, int32, AmmoCount);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryActiveSlotChangedSignature, int32, PreviousSlotIndex, int32, NewSlotIndex);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FInventoryItemOwnerChanged, class AItem*, class AActor*);
+
+/**
+ * Fixed-capacity item slots and per-type ammo counts. Owners react to the
+ * change events instead of polling, and select slots through SelectSlot so
+ * players, bots and AI survivors share the same path.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class ZOMBIETEAMPROJECT_API UInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	UInventoryComponent();
+
+	static constexpr int32 INVENTORY_CAPACITY{ 6 };
+
+	/** Fired on the server when an item enters (new owner) or leaves (nullptr) any inventory */
+	static FInventoryItemOwnerChanged NotifyItemOwnerChanged;
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	/** Replicated changes fire the same events as local ones */
+	UFUNCTION()
+	void OnRep_Slots();
+
+	UFUNCTION()
+	void OnRep_AmmoCounts();
+
+	UFUNCTION()
+	void OnRep_ActiveSlot(int32 PreviousActiveSlot);
+
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Put the item in the first free slot; returns the slot index, or INDEX_NONE when full */
+	int32 AddItem(AItem* Item);
+
+	/** Replace the item in a slot and return the item that was there */
+	AItem* SetItemAt(int32 SlotIndex, AItem* Item);
+
+	/** Make SlotIndex the active slot; returns false if it is empty, invalid or already active */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool SelectSlot(int32 SlotIndex);
+
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void AddAmmo(EAmmoType AmmoType, int32 Amount);
+
+	/** Remove up to Amount rounds and return how many were taken */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	int32 TakeAmmo(EAmmoType AmmoType, int32 Amount);
+
+	UPROPERTY(BlueprintAssignable, Category = Inventory)
+	FInventorySlotChangedSignature OnSlotChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = Inventory)
+	FInventoryAmmoChangedSignature OnAmmoChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = Inventory)
+	FInventoryActiveSlotChangedSignature OnActiveSlotChanged;
+
+private:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_Slots, Category = Inventory, meta = (AllowPrivateAccess = "true"))
+	AItem* Slots[INVENTORY_CAPACITY];
+
+	/** Ammo carried when play begins */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Inventory, meta = (AllowPrivateAccess = "true", ArraySizeEnum = "EAmmoType"))
+	int32 StartingAmmo[static_cast<uint8>(EAmmoType::EAT_MAX)];
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_AmmoCounts, Category = Inventory, meta = (AllowPrivateAccess = "true", ArraySizeEnum = "EAmmoType"))
+	int32 AmmoCounts[static_cast<uint8>(EAmmoType::EAT_MAX)];
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_ActiveSlot, Category = Inventory, meta = (AllowPrivateAccess = "true"))
+	int32 ActiveSlot;
+
+	int32 NumItems;
+
+public:
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	AItem* GetItemAt(int32 SlotIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	int32 GetAmmo(EAmmoType AmmoType) const;
+
+	FORCEINLINE int32 GetActiveSlot() const { return ActiveSlot; }
+	FORCEINLINE int32 GetNumItems() const { return NumItems; }
+	FORCEINLINE bool IsFull() const { return NumItems >= INVENTORY_CAPACITY; }
+};
@@ -4,25 +4,82 @@
 #include "Item.h"
 #include "Components/BoxComponent.h"
 #include "Components/WidgetComponent.h"
-#include "Components/SphereComponent.h"
 #include "MainCharacter.h"
+#include "PickupSubsystem.h"
+#include "ZombieTeamProject.h"
+#include "Net/UnrealNetwork.h"
+
+namespace
+{
+	constexpr ECollisionEnabled::Type NoCollision{ ECollisionEnabled::NoCollision };
+	constexpr ECollisionEnabled::Type QueryAndPhysics{ ECollisionEnabled::QueryAndPhysics };
+	constexpr ECollisionResponse Ignore{ ECollisionResponse::ECR_Ignore };
+	constexpr ECollisionChannel NoChannel{ ECollisionChannel::ECC_MAX };
+
+	/** Component settings for every item state, indexed by EItemState then EItemComponent */
+	constexpr FItemComponentProfile ItemComponentProfiles[static_cast<uint8>(EItemState::EIS_MAX)][static_cast<uint8>(EItemComponent::EIC_MAX)] =
+	{
+		// EIS_Pickup
+		{
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+			{ QueryAndPhysics, Ignore, ECC_Interactable, false, false, true },
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+		},
+		// EIS_EquipInterping
+		{
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+		},
+		// EIS_PickedUp
+		{
+			{ NoCollision, Ignore, NoChannel, false, false, false },
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+			{ NoCollision, Ignore, NoChannel, false, false, false },
+		},
+		// EIS_Equipped
+		{
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+		},
+		// EIS_Falling
+		{
+			{ QueryAndPhysics, Ignore, ECollisionChannel::ECC_WorldStatic, true, true, true },
+			{ NoCollision, Ignore, NoChannel, false, false, true },
+			{ QueryAndPhysics, Ignore, ECollisionChannel::ECC_WorldStatic, true, true, true },
+		},
+	};
+}
 
 // Sets default values
 AItem::AItem() : 
 	ItemName(FString("Default")),
+	PickupRadius(200.f),
 	ItemCount(0),
+	SettleSpeed(5.f),
+	SettleTime(0.5f),
+	MaxFallingTime(10.f),
+	FallingTime(0.f),
+	RestingTime(0.f),
 	ItemState(EItemState::EIS_Pickup),
 	ZCurveTime(0.7f),
 	ItemInterpStartLocation(FVector(0.f)),
 	CameraTargetLocation(FVector(0.f)),
 	isInterping(false),
-	ItemInterpX(0.f),
-	ItemInterpY(0.f),
 	SlotIndex(0)
 
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	LLM_SCOPE_BYTAG(ZombieItems);
+
+ 	// Items only tick while they fall; pickup interpolation runs in UPickupSubsystem
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	bReplicates = true;
+	SetReplicatingMovement(true);
+	NetUpdateFrequency = 10.f;
+	NetCullDistanceSquared = FMath::Square(5000.f);
 
 	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
 	SetRootComponent(ItemMesh);
@@ -30,150 +87,137 @@ AItem::AItem() :
 	CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
 	CollisionBox->SetupAttachment(ItemMesh);
     CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-	CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility,
+	CollisionBox->SetCollisionResponseToChannel(ECC_Interactable,
 		                                        ECollisionResponse::ECR_Block);
 
 	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
 	PickupWidget->SetupAttachment(GetRootComponent());
-
-	AreaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AreaSphere"));
-	AreaSphere->SetupAttachment(GetRootComponent());
 }
 
 // Called when the game starts or when spawned
 void AItem::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(ZombieItems);
+
 	Super::BeginPlay();
 	
 	// Pickup widget only visible when the character gets close to weapon
 	PickupWidget->SetVisibility(false);
 
-	// Overlap for AreaSphere
+	SetItemProperties(ItemState);
+	UpdatePickupRegistration();
+	UpdateNetDormancy();
+}
 
-	AreaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
-	AreaSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>())
+	{
+		Pickups->UnregisterPickup(this);
+		Pickups->UnregisterFallingItem(this);
+	}
 
-	SetItemProperties(ItemState);
+	Super::EndPlay(EndPlayReason);
+}
 
+void AItem::UpdatePickupRegistration()
+{
+	UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>();
+	if (Pickups == nullptr) return;
 
+	if (ItemState == EItemState::EIS_Pickup)
+	{
+		Pickups->RegisterPickup(this);
+	}
+	else
+	{
+		Pickups->UnregisterPickup(this);
+	}
 }
 
-void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AItem::UpdateFallingRegistration(EItemState PreviousState)
 {
-	if (OtherActor)
+	if (ItemState == PreviousState) return;
+
+	UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>();
+	if (ItemState == EItemState::EIS_Falling)
 	{
-		AMainCharacter* MainCharacter = Cast<AMainCharacter>(OtherActor);
+		FallingTime = 0.f;
+		RestingTime = 0.f;
+		SetActorTickEnabled(true);
 
-		if (MainCharacter)
+		if (Pickups)
 		{
-			MainCharacter->IncrementOverlappedItemCount(1);
+			Pickups->RegisterFallingItem(this);
 		}
 	}
-}
-
-void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
-{
-	if (OtherActor)
+	else if (PreviousState == EItemState::EIS_Falling)
 	{
-		AMainCharacter* MainCharacter = Cast<AMainCharacter>(OtherActor);
+		SetActorTickEnabled(false);
 
-		if (MainCharacter)
+		if (Pickups)
 		{
-			MainCharacter->IncrementOverlappedItemCount(-1);
+			Pickups->UnregisterFallingItem(this);
 		}
 	}
 }
 
 void AItem::SetItemProperties(EItemState State)
 {
-	switch (State)
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_ItemSetProperties);
+
+	ApplyComponentProfile(ItemMesh, State, EItemComponent::EIC_Mesh);
+	ApplyComponentProfile(CollisionBox, State, EItemComponent::EIC_CollisionBox);
+
+	if (State != EItemState::EIS_Pickup && PickupWidget->IsVisible())
 	{
-	case EItemState::EIS_Pickup:
-		//Set ItemMesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		PickupWidget->SetVisibility(false);
+	}
+}
 
-		//Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+void AItem::ApplyComponentProfile(UPrimitiveComponent* Component, EItemState State, EItemComponent Role)
+{
+	if (Component == nullptr || State == EItemState::EIS_MAX) return;
 
-		//Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		break;
+	const FItemComponentProfile& Profile =
+		ItemComponentProfiles[static_cast<uint8>(State)][static_cast<uint8>(Role)];
 
-	case EItemState::EIS_Equipped:
-		PickupWidget->SetVisibility(false);
-		//Set ItemMesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		//Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		//Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-
-	case EItemState::EIS_Falling:
-		ItemMesh->SetSimulatePhysics(true);
-		ItemMesh->SetEnableGravity(true);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic,
-			                                    ECollisionResponse::ECR_Block);
-
-		//Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		//Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-
-	case EItemState::EIS_EquipInterping:
-		PickupWidget->SetVisibility(false);
-		//Set ItemMesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(true);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		//Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-		//Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
-
-	case EItemState::EIS_PickedUp:
-		PickupWidget->SetVisibility(false);
-		// Set mesh properties
-		ItemMesh->SetSimulatePhysics(false);
-		ItemMesh->SetEnableGravity(false);
-		ItemMesh->SetVisibility(false);
-		ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set AreaSphere properties
-		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		AreaSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		// Set CollisionBox properties
-		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		break;
+	// Stop simulating before collision changes so the body is not rebuilt twice
+	const bool bSimulateChanged{ Component->IsSimulatingPhysics() != Profile.bSimulatePhysics };
+	if (bSimulateChanged && !Profile.bSimulatePhysics)
+	{
+		Component->SetSimulatePhysics(false);
+	}
+
+	if (Component->IsGravityEnabled() != Profile.bEnableGravity)
+	{
+		Component->SetEnableGravity(Profile.bEnableGravity);
+	}
+
+	FCollisionResponseContainer Responses(Profile.DefaultResponse);
+	if (Profile.BlockChannel != ECollisionChannel::ECC_MAX)
+	{
+		Responses.SetResponse(Profile.BlockChannel, ECollisionResponse::ECR_Block);
+	}
+	const FCollisionResponseContainer& CurrentResponses = Component->GetCollisionResponseToChannels();
+	if (FMemory::Memcmp(CurrentResponses.EnumArray, Responses.EnumArray, sizeof(Responses.EnumArray)) != 0)
+	{
+		Component->SetCollisionResponseToChannels(Responses);
+	}
+
+	if (Component->GetCollisionEnabled() != Profile.CollisionEnabled)
+	{
+		Component->SetCollisionEnabled(Profile.CollisionEnabled);
+	}
+
+	if (bSimulateChanged && Profile.bSimulatePhysics)
+	{
+		Component->SetSimulatePhysics(true);
+	}
+
+	if (Component->IsVisible() != Profile.bVisible)
+	{
+		Component->SetVisibility(Profile.bVisible);
 	}
 }
 
@@ -187,34 +231,56 @@ void AItem::FinishInterping()
 	}
 }
 
-void AItem::ItemInterp(float DeltaTime)
+UPrimitiveComponent* AItem::GetPhysicsComponent() const
 {
-	if (!isInterping) return;
+	return ItemMesh;
+}
 
-	if (Character && ItemZCurve)
-	{
-		const float ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpTimer);
-		const float CurveValue = ItemZCurve->GetFloatValue(ElapsedTime);
+void AItem::UpdateFalling(float DeltaTime)
+{
+	FallingTime += DeltaTime;
 
-		FVector ItemLocation = ItemInterpStartLocation;
-		const FVector CameraInterpLocation{ Character->GetCameraInterpLocation() };
-		const FVector ItemToCamera{ FVector(0.f, 0.f, (CameraInterpLocation - ItemLocation).Z) };
+	UPrimitiveComponent* PhysicsComponent = GetPhysicsComponent();
+	const bool bResting{ !PhysicsComponent->RigidBodyIsAwake() ||
+		PhysicsComponent->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(SettleSpeed) };
+	RestingTime = bResting ? RestingTime + DeltaTime : 0.f;
 
-		const float DeltaZ = ItemToCamera.Size();
+	if (RestingTime >= SettleTime || FallingTime >= MaxFallingTime)
+	{
+		Settle();
+	}
+}
 
-		const FVector CurrentLocation{ GetActorLocation() };
-		const float InterpXValue = FMath::FInterpTo(CurrentLocation.X, CameraInterpLocation.X, 
-			                                        DeltaTime,
-			                                        30.0f);
-		const float InterpYValue = FMath::FInterpTo(CurrentLocation.Y, CameraInterpLocation.Y,
-			                                        DeltaTime,
-			                                        30.0f);
+void AItem::Settle()
+{
+	if (ItemState != EItemState::EIS_Falling) return;
 
-		ItemLocation.X = InterpXValue;
-		ItemLocation.Y = InterpYValue;
+	// The falling cap and MaxFallingTime can stop an item mid-air or sliding down a slope
+	const bool bResting{ RestingTime >= SettleTime };
+	SetItemState(EItemState::EIS_Pickup);
+	if (!bResting)
+	{
+		PlaceOnGround();
+	}
+}
 
-		ItemLocation.Z += CurveValue * DeltaZ;
-		SetActorLocation(ItemLocation, true, nullptr, ETeleportType::TeleportPhysics);
+void AItem::PlaceOnGround()
+{
+	const FBox Bounds{ GetPhysicsComponent()->Bounds.GetBox() };
+	const FVector Start{ Bounds.GetCenter() };
+	const FVector End{ Start - FVector(0.f, 0.f, 10'000.f) };
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ItemPlaceOnGround), false, this);
+	FCollisionResponseParams ResponseParams;
+	ResponseParams.CollisionResponse.SetResponse(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Ignore);
+	ResponseParams.CollisionResponse.SetResponse(ECollisionChannel::ECC_PhysicsBody, ECollisionResponse::ECR_Ignore);
+
+	FHitResult GroundHit;
+	INC_DWORD_STAT(STAT_ZombieTraces);
+	if (GetWorld()->LineTraceSingleByChannel(GroundHit, Start, End, ECollisionChannel::ECC_Visibility, QueryParams, ResponseParams))
+	{
+		// Rest the bottom of the item's bounds on the ground below its center
+		AddActorWorldOffset(FVector(0.f, 0.f, GroundHit.ImpactPoint.Z - Bounds.Min.Z), false, nullptr, ETeleportType::TeleportPhysics);
 	}
 }
 
@@ -223,13 +289,50 @@ void AItem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	ItemInterp(DeltaTime);
+	// Settling changes the item state, which only the server decides
+	if (ItemState == EItemState::EIS_Falling && HasAuthority())
+	{
+		UpdateFalling(DeltaTime);
+	}
+}
+
+void AItem::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AItem, ItemState);
+	DOREPLIFETIME(AItem, ItemCount);
+}
+
+void AItem::OnRep_ItemState()
+{
+	SetItemProperties(ItemState);
+	UpdatePickupRegistration();
 }
 
 void AItem::SetItemState(EItemState State)
 {
+	const EItemState PreviousState{ ItemState };
 	ItemState = State;
 	SetItemProperties(State);
+	UpdatePickupRegistration();
+	UpdateFallingRegistration(PreviousState);
+	UpdateNetDormancy();
+}
+
+void AItem::UpdateNetDormancy()
+{
+	if (!HasAuthority()) return;
+
+	// Pickups lying in the world never change until someone interacts with them
+	if (ItemState == EItemState::EIS_Pickup)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+	else if (NetDormancy > DORM_Awake)
+	{
+		SetNetDormancy(DORM_Awake);
+	}
 }
 
 void AItem::StartItemCurve(AMainCharacter* Char)
@@ -241,5 +344,8 @@ void AItem::StartItemCurve(AMainCharacter* Char)
 	isInterping = true;
 	SetItemState(EItemState::EIS_EquipInterping);
 
-	GetWorldTimerManager().SetTimer(ItemInterpTimer, this, &AItem::FinishInterping, ZCurveTime);
+	if (UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>())
+	{
+		Pickups->StartItemInterp(this, Char);
+	}
 }
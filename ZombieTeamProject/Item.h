@@ -18,6 +18,33 @@ enum class EItemState : uint8
 	EIS_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/** Item components whose collision and physics settings follow the item state */
+enum class EItemComponent : uint8
+{
+	EIC_Mesh,
+	EIC_CollisionBox,
+	/** Extra mesh owned by a subclass, such as AAmmo::AmmoMesh */
+	EIC_AuxMesh,
+
+	EIC_MAX
+};
+
+/** Collision, physics and visibility of one item component in one item state */
+struct FItemComponentProfile
+{
+	ECollisionEnabled::Type CollisionEnabled;
+
+	/** Response to every channel except BlockChannel */
+	ECollisionResponse DefaultResponse;
+
+	/** Channel the component blocks, ECC_MAX for none */
+	ECollisionChannel BlockChannel;
+
+	bool bSimulatePhysics;
+	bool bEnableGravity;
+	bool bVisible;
+};
+
 UCLASS()
 class ZOMBIETEAMPROJECT_API AItem : public AActor
 {
@@ -31,27 +58,40 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-	UFUNCTION()
-	void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, 
-		                 AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		                 int32 OtherBodyIndex, bool bFromSweep,
-		                 const FHitResult& SweepResult);
-
-	UFUNCTION()
-	void OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent,
-		                    AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		                    int32 OtherBodyIndex);
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	virtual void SetItemProperties(EItemState State);
 
-	void FinishInterping();
+	/** Apply the profile for State to Component, skipping every setting that already matches */
+	static void ApplyComponentProfile(UPrimitiveComponent* Component, EItemState State, EItemComponent Role);
+
+	/** Keep the pickup index in sync with whether the item lies in the world as a pickup */
+	void UpdatePickupRegistration();
+
+	/** The component that simulates physics while the item falls */
+	virtual UPrimitiveComponent* GetPhysicsComponent() const;
+
+	/** Check whether a falling item has come to rest */
+	void UpdateFalling(float DeltaTime);
+
+	/** Drop the item straight down onto whatever is below it; used when it settles before coming to rest */
+	void PlaceOnGround();
 
-	void ItemInterp(float DeltaTime);
+	/** Track falling items with the pickup subsystem so it can cap how many simulate at once */
+	void UpdateFallingRegistration(EItemState PreviousState);
+
+	UFUNCTION()
+	void OnRep_ItemState();
+
+	/** Pickups at rest go dormant on the network; every other state replicates */
+	void UpdateNetDormancy();
 
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 private:
 	/** Skeletal mesh for the item*/
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
@@ -65,18 +105,34 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class UWidgetComponent* PickupWidget;
 
+	/** Characters within this distance start tracing for the item */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	class USphereComponent* AreaSphere;
+	float PickupRadius;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	FString ItemName;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_ItemState, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	EItemState ItemState;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	int32 ItemCount;
 
+	/** A falling item slower than this, in cm/s, counts as resting */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	float SettleSpeed;
+
+	/** Seconds a falling item must rest before it becomes a pickup again */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	float SettleTime;
+
+	/** Falling items settle after this many seconds even if they are still moving */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	float MaxFallingTime;
+
+	float FallingTime;
+	float RestingTime;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class UCurveFloat* ItemZCurve;
 
@@ -89,17 +145,12 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	bool isInterping;
 
-	FTimerHandle ItemInterpTimer;
-
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float ZCurveTime;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class AMainCharacter* Character;
 
-	float ItemInterpX;
-	float ItemInterpY;
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	class USoundCue* PickupSound;
 
@@ -119,18 +170,27 @@ private:
 public:
 
 	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget; }
-	FORCEINLINE USphereComponent* GetAreaSphere() const { return AreaSphere; }
+	FORCEINLINE float GetPickupRadius() const { return PickupRadius; }
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return CollisionBox; }
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 	void SetItemState(EItemState State);
 	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
 	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
+	FORCEINLINE void SetItemCount(int32 Count) { ItemCount = Count; }
 	FORCEINLINE USoundCue* GetPickupSound() const { return PickupSound; }
 	FORCEINLINE void SetPickupSound(USoundCue* Sound) { PickupSound = Sound; }
 	void StartItemCurve(AMainCharacter* Char);
+
+	/** Called by the pickup subsystem when the item reaches the character */
+	void FinishInterping();
+
+	/** Stop simulating a falling item and turn it back into a pickup where it lies */
+	void Settle();
 	FORCEINLINE void SetItemName(FString Name) { ItemName = Name; }
 	FORCEINLINE void SetWeaponIcon(UTexture2D* Icon) { WeaponIcon = Icon; }
 	FORCEINLINE void SetWeaponAmmoIcon(UTexture2D* Icon) { WeaponAmmoIcon = Icon; }
+	FORCEINLINE UCurveFloat* GetItemZCurve() const { return ItemZCurve; }
+	FORCEINLINE float GetZCurveTime() const { return ZCurveTime; }
 	FORCEINLINE int32 GetSlotIndex() const { return SlotIndex; }
 	FORCEINLINE void SetSlotIndex(int32 Index) { SlotIndex = Index; }
 };
@@ -0,0 +1,244 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LootManager.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "EngineUtils.h"
+#include "Engine/StaticMesh.h"
+#include "Item.h"
+#include "Ammo.h"
+#include "GameplayTelemetry.h"
+#include "ZombieTeamProject.h"
+#include "Net/UnrealNetwork.h"
+
+// Sets default values
+ALootManager::ALootManager() :
+	PromoteDistance(1500.f),
+	DemoteDistance(2500.f),
+	UpdateInterval(0.25f)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+
+	// Far loot has to be drawn wherever a player is
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 4.f;
+}
+
+// Called when the game starts or when spawned
+void ALootManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Placed pickups are replicated; clients see them destroyed when the server instances them
+	if (!HasAuthority()) return;
+
+	// Everything starts out instanced; the first update promotes what is near a player
+	TArray<AItem*, TInlineAllocator<256>> PlacedItems;
+	for (TActorIterator<AItem> It(GetWorld()); It; ++It)
+	{
+		if (It->GetItemState() == EItemState::EIS_Pickup)
+		{
+			PlacedItems.Add(*It);
+		}
+	}
+	for (AItem* Item : PlacedItems)
+	{
+		DemoteItem(Item);
+	}
+
+	GetWorldTimerManager().SetTimer(
+		UpdateTimer,
+		this,
+		&ALootManager::UpdateLoot,
+		UpdateInterval,
+		true,
+		0.f);
+}
+
+void ALootManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ALootManager, ReplicatedLoot);
+}
+
+void ALootManager::OnRep_ReplicatedLoot()
+{
+	for (UInstancedStaticMeshComponent* Instances : InstanceComponents)
+	{
+		Instances->ClearInstances();
+	}
+
+	for (const FReplicatedLoot& Loot : ReplicatedLoot)
+	{
+		if (Loot.ItemClass == nullptr) continue;
+
+		// Clients have no item to copy the mesh from, so the class defaults stand in
+		const int32 TypeIndex{ FindOrAddLootType(Loot.ItemClass->GetDefaultObject<AItem>()) };
+		if (TypeIndex != INDEX_NONE)
+		{
+			InstanceComponents[TypeIndex]->AddInstanceWorldSpace(FTransform(Loot.Rotation, Loot.Location, Loot.Scale));
+		}
+	}
+}
+
+int32 ALootManager::FindOrAddLootType(const AItem* Item)
+{
+	const int32 ExistingIndex{ LootTypes.IndexOfByPredicate([Item](const FLootType& LootType)
+	{
+		return LootType.ItemClass == Item->GetClass();
+	}) };
+	if (ExistingIndex != INDEX_NONE) return ExistingIndex;
+
+	// Ammo draws its own static mesh; other items need a configured mesh
+	UStaticMesh* Mesh = nullptr;
+	const UMeshComponent* SourceComponent = nullptr;
+	for (const FLootInstanceMesh& InstanceMesh : InstanceMeshes)
+	{
+		if (InstanceMesh.ItemClass == Item->GetClass())
+		{
+			Mesh = InstanceMesh.InstanceMesh;
+			break;
+		}
+	}
+	if (Mesh == nullptr)
+	{
+		if (const AAmmo* Ammo = Cast<AAmmo>(Item))
+		{
+			Mesh = Ammo->GetAmmoMesh()->GetStaticMesh();
+			SourceComponent = Ammo->GetAmmoMesh();
+		}
+	}
+	if (Mesh == nullptr) return INDEX_NONE;
+
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(this);
+	Instances->SetupAttachment(GetRootComponent());
+	Instances->SetStaticMesh(Mesh);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetCanEverAffectNavigation(false);
+	if (SourceComponent)
+	{
+		for (int32 MaterialIndex = 0; MaterialIndex < SourceComponent->GetNumMaterials(); ++MaterialIndex)
+		{
+			Instances->SetMaterial(MaterialIndex, SourceComponent->GetMaterial(MaterialIndex));
+		}
+	}
+	Instances->RegisterComponent();
+
+	InstanceComponents.Add(Instances);
+	FLootType& LootType = LootTypes.AddDefaulted_GetRef();
+	LootType.ItemClass = Item->GetClass();
+	return LootTypes.Num() - 1;
+}
+
+bool ALootManager::DemoteItem(AItem* Item)
+{
+	const int32 TypeIndex{ FindOrAddLootType(Item) };
+	if (TypeIndex == INDEX_NONE) return false;
+
+	const FTransform ItemTransform{ Item->GetActorTransform() };
+	InstanceComponents[TypeIndex]->AddInstanceWorldSpace(ItemTransform);
+
+	FLootType& LootType = LootTypes[TypeIndex];
+	LootType.Transforms.Add(ItemTransform);
+	LootType.ItemCounts.Add(Item->GetItemCount());
+	ZOMBIE_TELEMETRY_INC(InstancedLoot);
+
+	FReplicatedLoot& Loot = ReplicatedLoot.AddDefaulted_GetRef();
+	Loot.ItemClass = LootType.ItemClass;
+	Loot.Location = ItemTransform.GetLocation();
+	Loot.Rotation = ItemTransform.Rotator();
+	Loot.Scale = ItemTransform.GetScale3D();
+
+	Item->Destroy();
+	return true;
+}
+
+void ALootManager::PromoteInstance(int32 TypeIndex, int32 InstanceIndex)
+{
+	LLM_SCOPE_BYTAG(ZombieItems);
+
+	FLootType& LootType = LootTypes[TypeIndex];
+
+	const FVector Location{ LootType.Transforms[InstanceIndex].GetLocation() };
+	const int32 ReplicatedIndex{ ReplicatedLoot.IndexOfByPredicate([&LootType, &Location](const FReplicatedLoot& Loot)
+	{
+		return Loot.ItemClass == LootType.ItemClass && Loot.Location == Location;
+	}) };
+	if (ReplicatedIndex != INDEX_NONE)
+	{
+		ReplicatedLoot.RemoveAtSwap(ReplicatedIndex, 1, false);
+	}
+
+	AItem* Item = GetWorld()->SpawnActorDeferred<AItem>(
+		LootType.ItemClass,
+		LootType.Transforms[InstanceIndex]);
+	ZOMBIE_TELEMETRY_INC(ActorsSpawned);
+	if (Item)
+	{
+		Item->SetItemCount(LootType.ItemCounts[InstanceIndex]);
+		Item->FinishSpawning(LootType.Transforms[InstanceIndex]);
+		PromotedLoot.Add({ Item, TypeIndex });
+	}
+
+	// Instances keep their order on removal, so the per-instance arrays stay in step
+	InstanceComponents[TypeIndex]->RemoveInstance(InstanceIndex);
+	ZOMBIE_TELEMETRY_ADD(InstancedLoot, -1);
+	LootType.Transforms.RemoveAt(InstanceIndex, 1, false);
+	LootType.ItemCounts.RemoveAt(InstanceIndex, 1, false);
+}
+
+void ALootManager::UpdateLoot()
+{
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			PlayerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	auto IsNearAnyPlayer = [&PlayerLocations](const FVector& Location, float Distance)
+	{
+		const float DistanceSquared{ FMath::Square(Distance) };
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			if (FVector::DistSquared(PlayerLocation, Location) <= DistanceSquared) return true;
+		}
+		return false;
+	};
+
+	// Promoted items that were picked up are no longer loot; far away ones go back to instances
+	for (int32 Index = PromotedLoot.Num() - 1; Index >= 0; --Index)
+	{
+		AItem* Item = PromotedLoot[Index].Item.Get();
+		if (Item == nullptr || Item->GetItemState() != EItemState::EIS_Pickup)
+		{
+			PromotedLoot.RemoveAtSwap(Index, 1, false);
+		}
+		else if (!IsNearAnyPlayer(Item->GetActorLocation(), DemoteDistance))
+		{
+			PromotedLoot.RemoveAtSwap(Index, 1, false);
+			DemoteItem(Item);
+		}
+	}
+
+	if (PlayerLocations.Num() == 0) return;
+
+	for (int32 TypeIndex = 0; TypeIndex < LootTypes.Num(); ++TypeIndex)
+	{
+		const TArray<FTransform>& Transforms = LootTypes[TypeIndex].Transforms;
+		for (int32 InstanceIndex = Transforms.Num() - 1; InstanceIndex >= 0; --InstanceIndex)
+		{
+			if (IsNearAnyPlayer(Transforms[InstanceIndex].GetLocation(), PromoteDistance))
+			{
+				PromoteInstance(TypeIndex, InstanceIndex);
+			}
+		}
+	}
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "LootManager.generated.h"
+
+USTRUCT(BlueprintType)
+struct FLootInstanceMesh
+{
+	GENERATED_BODY()
+
+	/** Item class drawn with this mesh while it is far from every player */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<class AItem> ItemClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	class UStaticMesh* InstanceMesh;
+};
+
+/** One instanced item as clients see it: which item's mesh to draw, and where */
+USTRUCT()
+struct FReplicatedLoot
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<class AItem> ItemClass;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FRotator Rotation;
+
+	UPROPERTY()
+	FVector_NetQuantize100 Scale;
+};
+
+/**
+ * Keeps pickups that are far from every player as instances of one
+ * instanced static mesh per item class. An instance is promoted back to a
+ * real item actor when a player comes within PromoteDistance and demoted
+ * again once every player is farther than DemoteDistance. Only the server
+ * promotes and demotes; clients draw the instances from ReplicatedLoot.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API ALootManager : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	// Sets default values for this actor's properties
+	ALootManager();
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Rebuild the client's instances from the server's list */
+	UFUNCTION()
+	void OnRep_ReplicatedLoot();
+
+	/** Promote and demote loot based on the current player locations */
+	void UpdateLoot();
+
+	/** Replace a pickup actor with an instance; returns false if the item cannot be instanced */
+	bool DemoteItem(AItem* Item);
+
+	void PromoteInstance(int32 TypeIndex, int32 InstanceIndex);
+
+	/** Index of the loot type for the item's class, creating it on first use */
+	int32 FindOrAddLootType(const AItem* Item);
+
+private:
+	/** Meshes for item classes that have no static mesh of their own, such as weapons */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	TArray<FLootInstanceMesh> InstanceMeshes;
+
+	/** Instances closer than this to a player become real item actors */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	float PromoteDistance;
+
+	/** Promoted items farther than this from every player go back to being instances */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	float DemoteDistance;
+
+	/** Seconds between promotion checks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	float UpdateInterval;
+
+	/** One instanced mesh component per loot type, indexed like LootTypes */
+	UPROPERTY(VisibleAnywhere, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	TArray<class UInstancedStaticMeshComponent*> InstanceComponents;
+
+	struct FLootType
+	{
+		TSubclassOf<AItem> ItemClass;
+
+		/** Per-instance data, kept in the same order as the component's instances */
+		TArray<FTransform> Transforms;
+		TArray<int32> ItemCounts;
+	};
+	TArray<FLootType> LootTypes;
+
+	/** Every instance, for clients; entries are swap-removed so a promotion only resends one */
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedLoot)
+	TArray<FReplicatedLoot> ReplicatedLoot;
+
+	struct FPromotedLoot
+	{
+		TWeakObjectPtr<AItem> Item;
+		int32 TypeIndex;
+	};
+	TArray<FPromotedLoot> PromotedLoot;
+
+	FTimerHandle UpdateTimer;
+};
@@ -22,10 +22,19 @@
 #include "Enemy.h"
 #include "EnemyController.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "HitscanSubsystem.h"
+#include "ZombieTeamProject.h"
+#include "GameplayTelemetry.h"
+#include "PickupSubsystem.h"
+#include "InventoryComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "GameFramework/PlayerState.h"
 
 //////////////////////////////////////////////////////////////////////////
 // AMainCharacter
 
+FMainCharacterEquipWeapon AMainCharacter::NotifyEquipWeapon;
+
 AMainCharacter::AMainCharacter() :
 	/** Initializer list */
 	// Set our turn rates for input
@@ -40,15 +49,20 @@ AMainCharacter::AMainCharacter() :
 	fireRate(0.1f),
 	charShouldFire(true),
 	isFireButtonPressed(false),
+	RemoteAimStart(FVector::ZeroVector),
+	RemoteAimDirection(FVector::ForwardVector),
+	bHasRemoteAimRay(false),
+	MaxRemoteAimAngle(15.f),
+	MaxRemoteAimOffset(200.f),
 	charShouldTraceForItems(false),
-	//Ammo amounts
-	Starting9mmAmmo(85),
-	StartingARAmmo(120),
 	//Combat variables
 	CombatState(ECombatState::ECS_Unoccupied),
 	//Camera interp
 	CameraInterpDistance(250.f),
 	CameraInterpElevation(65.f),
+	bAutoPickupAmmo(false),
+	AmmoMagnetRadius(400.f),
+	InteractDistanceTolerance(150.f),
 	//Character health
 	Health(100.f),
 	MaxHealth(100.f)
@@ -73,6 +87,8 @@ AMainCharacter::AMainCharacter() :
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 
+	Inventory = CreateDefaultSubobject<UInventoryComponent>(TEXT("Inventory"));
+
 	// Don't rotate when the controller rotates. Let that just affect the camera.
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationYaw = true;
@@ -87,6 +103,8 @@ AMainCharacter::AMainCharacter() :
 
 float AMainCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	ZOMBIE_TELEMETRY_INC(DamageEvents);
+
 	if (Health - DamageAmount <= 0.f)
 	{
 		Health = 0.f;
@@ -95,6 +113,7 @@ float AMainCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageE
 		auto EnemyController = Cast<AEnemyController>(EventInstigator);
 		if (EnemyController)
 		{
+			ZOMBIE_TELEMETRY_INC(BlackboardWrites);
 			EnemyController->GetBlackboardComponent()->SetValueAsBool(FName(TEXT("MainCharacterDead")), true);
 		}
 	}
@@ -102,6 +121,7 @@ float AMainCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageE
 	{
 		Health -= DamageAmount;
 	}
+	OnHealthChanged.Broadcast(Health, MaxHealth);
 	return DamageAmount;
 }
 
@@ -141,12 +161,13 @@ void AMainCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInpu
 
 	PlayerInputComponent->BindAction("ReloadButton", IE_Pressed, this, &AMainCharacter::ReloadButtonPressed);
 
-	PlayerInputComponent->BindAction("FKey", IE_Pressed, this, &AMainCharacter::FKeyPressed);
-	PlayerInputComponent->BindAction("1Key", IE_Pressed, this, &AMainCharacter::OneKeyPressed);
-	PlayerInputComponent->BindAction("2Key", IE_Pressed, this, &AMainCharacter::TwoKeyPressed);
-	PlayerInputComponent->BindAction("3Key", IE_Pressed, this, &AMainCharacter::ThreeKeyPressed);
-	PlayerInputComponent->BindAction("4Key", IE_Pressed, this, &AMainCharacter::FourKeyPressed);
-	PlayerInputComponent->BindAction("5Key", IE_Pressed, this, &AMainCharacter::FiveKeyPressed);
+	DECLARE_DELEGATE_OneParam(FSelectSlotDelegate, int32);
+	static const FName SlotActions[]{ "FKey", "1Key", "2Key", "3Key", "4Key", "5Key" };
+	for (int32 SlotIndex = 0; SlotIndex < UE_ARRAY_COUNT(SlotActions); ++SlotIndex)
+	{
+		PlayerInputComponent->BindAction<FSelectSlotDelegate>(
+			SlotActions[SlotIndex], IE_Pressed, this, &AMainCharacter::SelectInventorySlot, SlotIndex);
+	}
 }
 
 
@@ -160,11 +181,53 @@ void AMainCharacter::BeginPlay()
 		CameraDefaultFOV = GetFollowCamera()->FieldOfView;
 	}
 
-	//This function will spawn the weapon and equip it to the main character
-	Equip(SpawnDefaultWeapon());
-	Inventory.Add(EquipWeapon);
-	EquipWeapon->SetSlotIndex(0);
-	InitializeAmmoMap();
+	// Nobody watches the pose here; montages still tick so their notifies fire
+	if (!ShouldPlayCosmetics(this))
+	{
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+
+	// Clients and replay playback receive the weapon through replication
+	if (HasAuthority())
+	{
+		//This function will spawn the weapon and equip it to the main character
+		Equip(SpawnDefaultWeapon());
+		Inventory->AddItem(EquipWeapon);
+		Inventory->OnActiveSlotChanged.AddDynamic(this, &AMainCharacter::OnActiveSlotChanged);
+	}
+}
+
+void AMainCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AMainCharacter, Health);
+	DOREPLIFETIME(AMainCharacter, CombatState);
+	DOREPLIFETIME(AMainCharacter, EquipWeapon);
+	DOREPLIFETIME_CONDITION(AMainCharacter, isAiming, COND_SkipOwner);
+}
+
+void AMainCharacter::OnRep_Health()
+{
+	OnHealthChanged.Broadcast(Health, MaxHealth);
+
+	if (Health <= 0.f)
+	{
+		MainCharacterDeath();
+	}
+}
+
+void AMainCharacter::OnRep_EquipWeapon()
+{
+	OnEquippedWeaponChanged.Broadcast(EquipWeapon);
+}
+
+void AMainCharacter::OnRep_CombatState()
+{
+	if (CombatState == ECombatState::ECS_Reloading)
+	{
+		PlayReloadMontage();
+	}
 }
 
 void AMainCharacter::TouchStarted(ETouchIndex::Type FingerIndex, FVector Location)
@@ -185,9 +248,7 @@ void AMainCharacter::FireWeapon()
 
 	if (WeaponHasAmmo())
 	{
-		PlayFireSound();
 		SendBullet();
-		PlayGunFireMontage();
 		EquipWeapon->DecrementAmmo();
 
 		StartFireTimer();
@@ -199,17 +260,42 @@ void AMainCharacter::AimingButtonPressed()
 {
 	isAiming = true;
 	GetFollowCamera()->SetFieldOfView(CameraZoomedFOV);
+
+	if (!HasAuthority())
+	{
+		ServerSetAiming(true);
+	}
 }
 
 void AMainCharacter::AimingButtonReleased()
 {
 	isAiming = false;
 	GetFollowCamera()->SetFieldOfView(CameraDefaultFOV);
+
+	if (!HasAuthority())
+	{
+		ServerSetAiming(false);
+	}
+}
+
+void AMainCharacter::ServerSetAiming_Implementation(bool bAiming)
+{
+	isAiming = bAiming;
 }
 
 void AMainCharacter::FireButtonPressed()
 {
 	isFireButtonPressed = true;
+
+	// The server fires and keeps the auto-fire loop going while the button is held
+	if (!HasAuthority())
+	{
+		FVector AimStart;
+		FVector AimDirection{ FVector::ForwardVector };
+		GetCrosshairRay(AimStart, AimDirection);
+		ServerSetFireButton(true, AimStart, AimDirection);
+		return;
+	}
 	FireWeapon();
 }
 
@@ -217,6 +303,31 @@ void AMainCharacter::FireButtonReleased()
 {
 	isFireButtonPressed = false;
 
+	if (!HasAuthority())
+	{
+		ServerSetFireButton(false, FVector::ZeroVector, FVector::ForwardVector);
+	}
+}
+
+void AMainCharacter::ServerSetFireButton_Implementation(bool bPressed, FVector_NetQuantize AimStart, FVector_NetQuantizeNormal AimDirection)
+{
+	if (bPressed)
+	{
+		ServerSetAimRay_Implementation(AimStart, AimDirection);
+		FireButtonPressed();
+	}
+	else
+	{
+		bHasRemoteAimRay = false;
+		FireButtonReleased();
+	}
+}
+
+void AMainCharacter::ServerSetAimRay_Implementation(FVector_NetQuantize AimStart, FVector_NetQuantizeNormal AimDirection)
+{
+	RemoteAimStart = AimStart;
+	RemoteAimDirection = AimDirection.GetSafeNormal();
+	bHasRemoteAimRay = !RemoteAimDirection.IsZero();
 }
 
 void AMainCharacter::StartFireTimer()
@@ -248,27 +359,53 @@ void AMainCharacter::AutoFireReset()
 	}
 }
 
-bool AMainCharacter::TraceWidgetUnderCrosshair(FHitResult& OutHitResult, FVector& OutHitLocation)
+bool AMainCharacter::GetCrosshairRay(FVector& OutStart, FVector& OutDirection) const
 {
-	//Get current size of the viewport
-	FVector2D ViewportSize;
-	if (GEngine && GEngine->GameViewport)
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	if (PlayerController == nullptr) return false;
+
+	if (!PlayerController->IsLocalController() || GEngine == nullptr || GEngine->GameViewport == nullptr)
 	{
-		GEngine->GameViewport->GetViewportSize(ViewportSize);
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(OutStart, ViewRotation);
+		OutDirection = ViewRotation.Vector();
+
+		// The crosshair sits off screen centre, so prefer the client's own ray unless it disagrees with its view
+		if (bHasRemoteAimRay
+			&& FVector::DistSquared(RemoteAimStart, OutStart) <= FMath::Square(MaxRemoteAimOffset)
+			&& (RemoteAimDirection | OutDirection) >= FMath::Cos(FMath::DegreesToRadians(MaxRemoteAimAngle)))
+		{
+			OutStart = RemoteAimStart;
+			OutDirection = RemoteAimDirection;
+		}
+		return true;
 	}
 
+	//Get current size of the viewport
+	FVector2D ViewportSize;
+	GEngine->GameViewport->GetViewportSize(ViewportSize);
+
 	//Get screen space location of crosshair
 	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
 	CrosshairLocation.Y -= 50.f;
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirectition;
 
 	//Get world position and direction of crosshair
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(
-		UGameplayStatics::GetPlayerController(this, 0),
+	return UGameplayStatics::DeprojectScreenToWorld(
+		PlayerController,
 		CrosshairLocation,
-		CrosshairWorldPosition,
-		CrosshairWorldDirectition);
+		OutStart,
+		OutDirection);
+}
+
+bool AMainCharacter::TraceWidgetUnderCrosshair(
+	FHitResult& OutHitResult,
+	FVector& OutHitLocation,
+	ECollisionChannel TraceChannel,
+	const FCollisionResponseParams& ResponseParams)
+{
+	FVector CrosshairWorldPosition;
+	FVector CrosshairWorldDirectition;
+	bool bScreenToWorld = GetCrosshairRay(CrosshairWorldPosition, CrosshairWorldDirectition);
 
 	if (bScreenToWorld)
 	{
@@ -276,8 +413,9 @@ bool AMainCharacter::TraceWidgetUnderCrosshair(FHitResult& OutHitResult, FVector
 		const FVector End{ Start + CrosshairWorldDirectition * 50'000.f };
 		OutHitLocation = End;
 
+		INC_DWORD_STAT(STAT_ZombieTraces);
 		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End,
-			ECollisionChannel::ECC_Visibility);
+			TraceChannel, FCollisionQueryParams::DefaultQueryParam, ResponseParams);
 		if (OutHitResult.bBlockingHit)
 		{
 			OutHitLocation = OutHitResult.Location;
@@ -288,14 +426,40 @@ bool AMainCharacter::TraceWidgetUnderCrosshair(FHitResult& OutHitResult, FVector
 	return false;
 }
 
+float AMainCharacter::GetShotRewindTime() const
+{
+	if (!HasAuthority() || IsLocallyControlled()) return 0.f;
+
+	const APlayerState* ShooterState = GetPlayerState();
+	if (ShooterState == nullptr) return 0.f;
+
+	// The enemy positions took half the round trip to reach the client and the shot the other half
+	return FMath::Min(ShooterState->ExactPing * 0.001f, UHitscanSubsystem::MAX_REWIND_TIME);
+}
+
 bool AMainCharacter::GetBeamEndLocation(
 	const FVector& MuzzleSocketLocation,
-	FHitResult& OutHitResult)
+	TArray<FHitResult>& OutHitResults,
+	FVector& OutBeamEndLocation)
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_GetBeamEndLocation);
+
+	// Enemies are covered by the hitscan structure, so the world traces ignore them
+	FCollisionResponseParams ResponseParams;
+	ResponseParams.CollisionResponse.SetResponse(
+		ECC_EnemyHitbox,
+		ECollisionResponse::ECR_Ignore);
+	ResponseParams.CollisionResponse.SetResponse(
+		ECollisionChannel::ECC_Pawn,
+		ECollisionResponse::ECR_Ignore);
+
 	FVector OutBeamLocation;
 	// Check for crosshair trace hit
 	FHitResult CrosshairHitResult;
-	bool bCrosshairHit = TraceWidgetUnderCrosshair(CrosshairHitResult, OutBeamLocation);
+	bool bCrosshairHit = TraceWidgetUnderCrosshair(CrosshairHitResult, OutBeamLocation, ECC_Bullet, ResponseParams);
+
+	UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+	const float RewindTime{ Hitscan && Hitscan->CanRewind() ? GetShotRewindTime() : 0.f };
 
 	if (bCrosshairHit)
 	{
@@ -307,31 +471,81 @@ bool AMainCharacter::GetBeamEndLocation(
 		// OutBeamLocation is the End location for the line trace
 	}
 
-	// Perform a second trace, this time from the gun barrel
+	// Perform a second trace, this time from the gun barrel. Enemies are tested
+	// against their hit capsules first; the world trace then only has to reach
+	// the last enemy the bullet can penetrate to check for cover
 	const FVector WeaponTraceStart{ MuzzleSocketLocation };
 	const FVector StartToEnd{ OutBeamLocation - WeaponTraceStart };
-	const FVector WeaponTraceEnd{ MuzzleSocketLocation + StartToEnd * 1.25f };
-	GetWorld()->LineTraceSingleByChannel(
-		OutHitResult,
+	const int32 PenetrationCount{ FMath::Max(EquipWeapon->GetPenetrationCount(), 0) };
+
+	// Penetrating shots carry on past the aim point to the end of the crosshair ray
+	const FVector CrosshairTraceEnd{ bCrosshairHit ? CrosshairHitResult.TraceEnd : OutBeamLocation };
+	const FVector WeaponTraceEnd{ PenetrationCount > 0
+		? WeaponTraceStart + StartToEnd.GetSafeNormal() * FVector::Dist(WeaponTraceStart, CrosshairTraceEnd)
+		: WeaponTraceStart + StartToEnd * 1.25f };
+
+	OutHitResults.Reset();
+	if (Hitscan)
+	{
+		// Remote shooters aimed at enemies as they were a round trip ago
+		if (RewindTime > 0.f)
+		{
+			Hitscan->LineTraceEnemiesAtTime(WeaponTraceStart, WeaponTraceEnd, GetWorld()->GetTimeSeconds() - RewindTime, OutHitResults);
+		}
+		else
+		{
+			Hitscan->LineTraceEnemies(WeaponTraceStart, WeaponTraceEnd, OutHitResults);
+		}
+	}
+
+	FVector WorldTraceEnd{ WeaponTraceEnd };
+	const int32 MaxEnemyHits{ 1 + PenetrationCount };
+	if (OutHitResults.Num() >= MaxEnemyHits)
+	{
+		OutHitResults.SetNum(MaxEnemyHits, false);
+		WorldTraceEnd = OutHitResults.Last().Location;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BulletOcclusionTrace), false, this);
+
+	FHitResult WorldHitResult;
+	INC_DWORD_STAT(STAT_ZombieTraces);
+	if (GetWorld()->LineTraceSingleByChannel(
+		WorldHitResult,
 		WeaponTraceStart,
-		WeaponTraceEnd,
-		ECollisionChannel::ECC_Visibility);
-	if (!OutHitResult.bBlockingHit) // object between barrel and BeamEndPoint?
+		WorldTraceEnd,
+		ECC_Bullet,
+		QueryParams,
+		ResponseParams))
+	{
+		// Enemies behind cover are not hit
+		OutHitResults.RemoveAll([&WorldHitResult](const FHitResult& EnemyHitResult)
+		{
+			return EnemyHitResult.Distance > WorldHitResult.Distance;
+		});
+		OutHitResults.Add(WorldHitResult);
+	}
+
+	if (OutHitResults.Num() == 0) // object between barrel and BeamEndPoint?
 	{
-		OutHitResult.Location = OutBeamLocation;
+		OutBeamEndLocation = OutBeamLocation;
 		return false;
 	}
 
+	const FHitResult& LastHitResult = OutHitResults.Last();
+	OutBeamEndLocation = LastHitResult.bBlockingHit ? LastHitResult.Location : WeaponTraceEnd;
 	return true;
 }
 
 void AMainCharacter::TraceForItems()
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_TraceForItems);
+
 	if (charShouldTraceForItems)
 	{
 		FHitResult ItemTraceResult;
 		FVector HitLocation;
-		TraceWidgetUnderCrosshair(ItemTraceResult, HitLocation);
+		TraceWidgetUnderCrosshair(ItemTraceResult, HitLocation, ECC_Interactable);
 
 		if (ItemTraceResult.bBlockingHit)
 		{
@@ -366,6 +580,7 @@ AWeapon* AMainCharacter::SpawnDefaultWeapon()
 	if (DefaultWeaponClass)
 	{
 		//Handles spawning the weapon in the world
+		ZOMBIE_TELEMETRY_INC(ActorsSpawned);
 		return GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass);
 	}
 
@@ -382,9 +597,11 @@ void AMainCharacter::Equip(AWeapon* EquippableWeapon)
 			HandSocket->AttachActor(EquippableWeapon, GetMesh());
 		}
 
+		AWeapon* PreviousWeapon = EquipWeapon;
 		EquipWeapon = EquippableWeapon;
 		EquipWeapon->SetItemState(EItemState::EIS_Equipped);
-
+		OnEquippedWeaponChanged.Broadcast(EquipWeapon);
+		NotifyEquipWeapon.Broadcast(this, PreviousWeapon, EquipWeapon);
 	}
 }
 
@@ -404,105 +621,118 @@ void AMainCharacter::InteractButtonPressed()
 
 	if (TraceHitItem)
 	{
-		TraceHitItem->StartItemCurve(this);
-
-		if (TraceHitItem->GetPickupSound())
+		if (HasAuthority())
+		{
+			InteractWithItem(TraceHitItem);
+		}
+		else
 		{
-			UGameplayStatics::PlaySound2D(this, TraceHitItem->GetPickupSound());
+			ServerInteract(TraceHitItem);
 		}
 	}
 
 }
 
-void AMainCharacter::InteractButtonReleased()
+void AMainCharacter::ServerInteract_Implementation(AItem* Item)
 {
-
+	InteractWithItem(Item);
 }
 
-void AMainCharacter::SwapWeapon(AWeapon* WeaponToSwap)
+void AMainCharacter::InteractWithItem(AItem* Item)
 {
-	if (Inventory.Num() - 1 >= EquipWeapon->GetSlotIndex())
-	{
-		Inventory[EquipWeapon->GetSlotIndex()] = WeaponToSwap;
-	}
+	// Clients pick the item from their own trace, so make sure it is still there and in reach
+	if (Item == nullptr || Item->GetItemState() != EItemState::EIS_Pickup) return;
 
-	DropWeapon();
-	Equip(WeaponToSwap);
-	TraceHitItem = nullptr;
-	TraceHitItemLastFrame = nullptr;
+	const float MaxDistance{ Item->GetPickupRadius() + InteractDistanceTolerance };
+	if (FVector::DistSquared(Item->GetActorLocation(), GetActorLocation()) > FMath::Square(MaxDistance)) return;
+
+	Item->StartItemCurve(this);
+	ClientPlayPickupSound(Item->GetPickupSound());
 }
 
-void AMainCharacter::InitializeAmmoMap()
+void AMainCharacter::ClientPlayPickupSound_Implementation(USoundCue* Sound)
 {
-	AmmoMap.Add(EAmmoType::EAT_9mm, Starting9mmAmmo);
-	AmmoMap.Add(EAmmoType::EAT_AR, StartingARAmmo);
+	if (Sound && ShouldPlayCosmetics(this))
+	{
+		UGameplayStatics::PlaySound2D(this, Sound);
+	}
 }
 
-bool AMainCharacter::WeaponHasAmmo()
+void AMainCharacter::InteractButtonReleased()
 {
-	if (EquipWeapon == nullptr) return false;
 
-	return EquipWeapon->GetAmmo() > 0;
 }
 
-void AMainCharacter::FKeyPressed()
+void AMainCharacter::SwapWeapon(AWeapon* WeaponToSwap)
 {
-	if (EquipWeapon->GetSlotIndex() == 0) return;
-	ExchangeInventoryItems(EquipWeapon->GetSlotIndex(), 0);
-}
+	Inventory->SetItemAt(EquipWeapon->GetSlotIndex(), WeaponToSwap);
 
-void AMainCharacter::OneKeyPressed()
-{
-	if (EquipWeapon->GetSlotIndex() == 1) return;
-	ExchangeInventoryItems(EquipWeapon->GetSlotIndex(), 1);
+	DropWeapon();
+	Equip(WeaponToSwap);
+	TraceHitItem = nullptr;
+	TraceHitItemLastFrame = nullptr;
 }
 
-void AMainCharacter::TwoKeyPressed()
+bool AMainCharacter::WeaponHasAmmo()
 {
-	if (EquipWeapon->GetSlotIndex() == 2) return;
-	ExchangeInventoryItems(EquipWeapon->GetSlotIndex(), 2);
-}
+	if (EquipWeapon == nullptr) return false;
 
-void AMainCharacter::ThreeKeyPressed()
-{
-	if (EquipWeapon->GetSlotIndex() == 3) return;
-	ExchangeInventoryItems(EquipWeapon->GetSlotIndex(), 3);
+	return EquipWeapon->GetAmmo() > 0;
 }
 
-void AMainCharacter::FourKeyPressed()
+void AMainCharacter::SelectInventorySlot(int32 SlotIndex)
 {
-	if (EquipWeapon->GetSlotIndex() == 4) return;
-	ExchangeInventoryItems(EquipWeapon->GetSlotIndex(), 4);
+	if (EquipWeapon == nullptr) return;
+
+	if (!HasAuthority())
+	{
+		ServerSelectInventorySlot(SlotIndex);
+		return;
+	}
+	Inventory->SelectSlot(SlotIndex);
 }
 
-void AMainCharacter::FiveKeyPressed()
+void AMainCharacter::ServerSelectInventorySlot_Implementation(int32 SlotIndex)
 {
-	if (EquipWeapon->GetSlotIndex() == 5) return;
-	ExchangeInventoryItems(EquipWeapon->GetSlotIndex(), 5);
+	SelectInventorySlot(SlotIndex);
 }
 
-void AMainCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex)
+void AMainCharacter::OnActiveSlotChanged(int32 PreviousSlotIndex, int32 NewSlotIndex)
 {
-	if ((CurrentItemIndex == NewItemIndex) || (NewItemIndex >= Inventory.Num())) return;
 	auto OldEquippedWeapon = EquipWeapon;
-	auto NewWeapon = Cast<AWeapon>(Inventory[NewItemIndex]);
+	auto NewWeapon = Cast<AWeapon>(Inventory->GetItemAt(NewSlotIndex));
+	if (NewWeapon == nullptr || NewWeapon == OldEquippedWeapon) return;
+
 	Equip(NewWeapon);
 
-	OldEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
+	if (OldEquippedWeapon)
+	{
+		OldEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
+	}
 	NewWeapon->SetItemState(EItemState::EIS_Equipped);
 }
 
 void AMainCharacter::PlayFireSound()
 {
 	//Play FireSound
-	if (FireSound)
+	if (FireSound && ShouldPlayCosmetics(this))
 	{
-		UGameplayStatics::PlaySound2D(this, FireSound);
+		if (IsLocallyControlled())
+		{
+			UGameplayStatics::PlaySound2D(this, FireSound);
+		}
+		else
+		{
+			UGameplayStatics::PlaySoundAtLocation(this, FireSound, GetActorLocation());
+		}
 	}
 }
 
 void AMainCharacter::SendBullet()
 {
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_SendBullet);
+	ZOMBIE_TELEMETRY_INC(BulletsFired);
+
 	// Send bullet
 	const USkeletalMeshSocket* BarrelSocket =
 		EquipWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
@@ -511,77 +741,156 @@ void AMainCharacter::SendBullet()
 		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(
 			EquipWeapon->GetItemMesh());
 
-		if (MuzzleFlash)
+		TArray<FHitResult> BeamHitResults;
+		FVector BeamEndLocation;
+		FVector ImpactLocation{ FVector::ZeroVector };
+		bool bSpawnImpact{ false };
+		bool bBeamEnd = GetBeamEndLocation(
+			SocketTransform.GetLocation(), BeamHitResults, BeamEndLocation);
+		if (bBeamEnd)
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
+			bSpawnImpact = ApplyBulletHits(BeamHitResults, BeamEndLocation, ImpactLocation);
 		}
 
-		FHitResult BeamHitResult;
-		bool bBeamEnd = GetBeamEndLocation(
-			SocketTransform.GetLocation(), BeamHitResult);
-		if (bBeamEnd)
+		MulticastFireEffects(BeamEndLocation, bBeamEnd, ImpactLocation, bSpawnImpact);
+	}
+}
+
+void AMainCharacter::MulticastFireEffects_Implementation(FVector_NetQuantize BeamEndLocation, bool bDrawBeam, FVector_NetQuantize ImpactLocation, bool bSpawnImpact)
+{
+	PlayFireSound();
+	PlayGunFireMontage();
+
+	if (EquipWeapon == nullptr) return;
+
+	if (!ShouldPlayCosmetics(this)) return;
+
+	const USkeletalMeshSocket* BarrelSocket =
+		EquipWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
+	if (BarrelSocket == nullptr) return;
+
+	const FTransform SocketTransform = BarrelSocket->GetSocketTransform(
+		EquipWeapon->GetItemMesh());
+
+	LLM_SCOPE_BYTAG(ZombieFX);
+
+	if (MuzzleFlash)
+	{
+		INC_DWORD_STAT(STAT_ZombieFXSpawned);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
+	}
+
+	if (bDrawBeam)
+	{
+		INC_DWORD_STAT(STAT_ZombieFXSpawned);
+		UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
+			GetWorld(),
+			BeamParticles,
+			SocketTransform);
+		if (Beam)
 		{
-			// Does hit Actor implement BulletHitInterface?
-			if (BeamHitResult.GetActor())
-			{
-				IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(BeamHitResult.GetActor());
-				if (BulletHitInterface)
-				{
-					BulletHitInterface->BulletHit_Implementation(BeamHitResult);
-				}
+			Beam->SetVectorParameter(FName("Target"), BeamEndLocation);
+		}
+	}
 
-				AEnemy* HitEnemy = Cast<AEnemy>(BeamHitResult.GetActor());
+	if (bSpawnImpact && ImpactParticles)
+	{
+		INC_DWORD_STAT(STAT_ZombieFXSpawned);
+		UGameplayStatics::SpawnEmitterAtLocation(
+			GetWorld(),
+			ImpactParticles,
+			ImpactLocation);
+	}
+}
 
-				if (HitEnemy)
-				{
-					int32 Damage{};
-					if (BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone())
-					{
-						//Head shot
-						Damage = EquipWeapon->GetHeadShotDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(),
-							Damage,
-							GetController(),
-							this,
-							UDamageType::StaticClass());
-					}
-					else
-					{
-						//Body shot
-						Damage = EquipWeapon->GetDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(),
-							Damage,
-							GetController(),
-							this,
-							UDamageType::StaticClass());
-					}
-
-					HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location);
+void AMainCharacter::ShowHitNumber(AEnemy* HitEnemy, int32 Damage, const FVector& HitLocation)
+{
+	if (!IsLocallyControlled())
+	{
+		ClientShowHitNumber(HitEnemy, Damage, HitLocation);
+		return;
+	}
 
-				}
-			}
-			else
+	// Bots on a server have nobody to show the number to
+	if (!ShouldPlayCosmetics(this)) return;
+
+	// The hit number widget is created by the enemy blueprint
+	LLM_SCOPE_BYTAG(ZombieWidgets);
+	HitEnemy->ShowHitNumber(Damage, HitLocation);
+}
+
+void AMainCharacter::ClientShowHitNumber_Implementation(AEnemy* HitEnemy, int32 Damage, FVector_NetQuantize HitLocation)
+{
+	if (HitEnemy)
+	{
+		ShowHitNumber(HitEnemy, Damage, HitLocation);
+	}
+}
+
+bool AMainCharacter::ApplyBulletHits(const TArray<FHitResult>& BeamHitResults, FVector& OutBeamEndLocation, FVector& OutImpactLocation)
+{
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_ApplyBulletHits);
+
+	// The bullet damages each enemy along the trace once, losing damage with every enemy it passes through
+	const int32 MaxEnemyHits{ 1 + FMath::Max(EquipWeapon->GetPenetrationCount(), 0) };
+	const float DamageKeptPerHit{ 1.f - FMath::Clamp(EquipWeapon->GetPenetrationDamageFalloff(), 0.f, 1.f) };
+	float DamageScale{ 1.f };
+	int32 EnemiesHit{ 0 };
+	bool bImpact{ false };
+	TArray<AActor*, TInlineAllocator<8>> HitActors;
+
+	for (const FHitResult& BeamHitResult : BeamHitResults)
+	{
+		AActor* HitActor = BeamHitResult.GetActor();
+		if (HitActor == nullptr)
+		{
+			// Default particles are spawned once, where the bullet stops
+			if (BeamHitResult.bBlockingHit)
 			{
-				// Spawn default particles
-				if (ImpactParticles)
-				{
-					UGameplayStatics::SpawnEmitterAtLocation(
-						GetWorld(),
-						ImpactParticles,
-						BeamHitResult.Location);
-				}
+				OutImpactLocation = BeamHitResult.Location;
+				bImpact = true;
 			}
+			continue;
+		}
+
+		// An actor is only hit once per shot
+		if (HitActors.Contains(HitActor)) continue;
+		HitActors.Add(HitActor);
+
+		AEnemy* HitEnemy = Cast<AEnemy>(HitActor);
+
+		// Does hit Actor implement BulletHitInterface?
+		IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(HitActor);
+		if (BulletHitInterface)
+		{
+			BulletHitInterface->BulletHit_Implementation(BeamHitResult);
+		}
 
-			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
-				GetWorld(),
-				BeamParticles,
-				SocketTransform);
-			if (Beam)
+		if (HitEnemy)
+		{
+			// Head shots use the weapon's head shot damage, every other zone scales body damage
+			const EHitZone HitZone{ HitEnemy->GetHitZone(BeamHitResult) };
+			const float ZoneDamage{ HitZone == EHitZone::EHZ_Head ?
+				EquipWeapon->GetHeadShotDamage() : EquipWeapon->GetDamage() };
+			const int32 Damage = ZoneDamage * HitEnemy->GetHitZoneDamageMultiplier(HitZone) * DamageScale;
+			UGameplayStatics::ApplyDamage(HitActor,
+				Damage,
+				GetController(),
+				this,
+				UDamageType::StaticClass());
+
+			ShowHitNumber(HitEnemy, Damage, BeamHitResult.Location);
+
+			DamageScale *= DamageKeptPerHit;
+			if (++EnemiesHit >= MaxEnemyHits)
 			{
-				Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
+				// Penetration used up, the bullet stops inside this enemy
+				OutBeamEndLocation = BeamHitResult.Location;
+				return bImpact;
 			}
 		}
 	}
+	return bImpact;
 }
 
 void AMainCharacter::PlayGunFireMontage()
@@ -596,6 +905,16 @@ void AMainCharacter::PlayGunFireMontage()
 }
 
 void AMainCharacter::ReloadButtonPressed()
+{
+	if (!HasAuthority())
+	{
+		ServerReload();
+		return;
+	}
+	ReloadWeapon();
+}
+
+void AMainCharacter::ServerReload_Implementation()
 {
 	ReloadWeapon();
 }
@@ -608,13 +927,19 @@ void AMainCharacter::ReloadWeapon()
 	if (CarriedAmmo())
 	{
 		CombatState = ECombatState::ECS_Reloading;
+		PlayReloadMontage();
+	}
+}
 
-		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-		if (AnimInstance && ReloadMontage)
-		{
-			AnimInstance->Montage_Play(ReloadMontage);
-			AnimInstance->Montage_JumpToSection(EquipWeapon->GetReloadMontageSection());
-		}
+void AMainCharacter::PlayReloadMontage()
+{
+	if (EquipWeapon == nullptr) return;
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance && ReloadMontage)
+	{
+		AnimInstance->Montage_Play(ReloadMontage);
+		AnimInstance->Montage_JumpToSection(EquipWeapon->GetReloadMontageSection());
 	}
 }
 
@@ -622,23 +947,12 @@ bool AMainCharacter::CarriedAmmo()
 {
 	if (EquipWeapon == nullptr) return false;
 
-	auto AmmoType = EquipWeapon->GetAmmoType();
-
-	if (AmmoMap.Contains(AmmoType))
-	{
-		return AmmoMap[AmmoType] > 0;
-	}
-	return false;
+	return Inventory->GetAmmo(EquipWeapon->GetAmmoType()) > 0;
 }
 
 void AMainCharacter::PickupAmmo(AAmmo* Ammo)
 {
-	if (AmmoMap.Find(Ammo->GetAmmoType()))
-	{
-		int32 AmmoCount{ AmmoMap[Ammo->GetAmmoType()] };
-		AmmoCount += Ammo->GetItemCount();
-		AmmoMap[Ammo->GetAmmoType()] = AmmoCount;
-	}
+	Inventory->AddAmmo(Ammo->GetAmmoType(), Ammo->GetItemCount());
 
 	if (EquipWeapon->GetAmmoType() == Ammo->GetAmmoType())
 	{
@@ -665,7 +979,7 @@ void AMainCharacter::MainCharacterDeath()
 void AMainCharacter::FinishDeath()
 {
 	GetMesh()->bPauseAnims = true;
-	APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0);
+	APlayerController* PC = Cast<APlayerController>(GetController());
 	if (PC)
 	{
 		DisableInput(PC);
@@ -721,56 +1035,77 @@ void AMainCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	//Check OverlappedItemCount and then trace for items
-	TraceForItems();
-}
-
-void AMainCharacter::FinishReloading()
-{
-	CombatState = ECombatState::ECS_Unoccupied;
-
-	if (EquipWeapon == nullptr) return;
-
-	const auto AmmoType{ EquipWeapon->GetAmmoType() };
-
-	if (AmmoMap.Contains(AmmoType))
+	// Only the player looking through this character traces for items, and only while a pickup is in range
+	if (IsLocallyControlled())
 	{
-		int32 CarriedAmmo = AmmoMap[AmmoType];
-
-		const int32 MagazineEmptySpace = EquipWeapon->GetMagazineCapacity() -
-			EquipWeapon->GetAmmo();
+		const UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>();
+		charShouldTraceForItems = Pickups && Pickups->IsAnyPickupInRange(GetActorLocation());
+		TraceForItems();
 
-		if (MagazineEmptySpace > CarriedAmmo)
-		{
-			EquipWeapon->ReloadAmmo(CarriedAmmo);
-			CarriedAmmo = 0;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
-		}
-		else
+		// Auto fire keeps shooting on the server, so keep it aiming where this client's crosshair is
+		if (isFireButtonPressed && !HasAuthority())
 		{
-			EquipWeapon->ReloadAmmo(MagazineEmptySpace);
-			CarriedAmmo -= MagazineEmptySpace;
-			AmmoMap.Add(AmmoType, CarriedAmmo);
+			FVector AimStart;
+			FVector AimDirection;
+			if (GetCrosshairRay(AimStart, AimDirection))
+			{
+				ServerSetAimRay(AimStart, AimDirection);
+			}
 		}
 	}
+
+	if (bAutoPickupAmmo && HasAuthority())
+	{
+		AttractNearbyAmmo();
+	}
 }
 
-void AMainCharacter::IncrementOverlappedItemCount(int8 Amount)
+void AMainCharacter::AttractNearbyAmmo()
 {
-	if (OverlappedItemCount + Amount <= 0)
+	UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>();
+	if (Pickups == nullptr) return;
+
+	TArray<AItem*> NearbyItems;
+	Pickups->GatherPickupsInRadius(GetActorLocation(), AmmoMagnetRadius, NearbyItems);
+
+	USoundCue* PickupSound = nullptr;
+	for (AItem* Item : NearbyItems)
 	{
-		OverlappedItemCount = 0;
-		charShouldTraceForItems = false;
+		if (Item->IsA<AAmmo>())
+		{
+			// Starting the curve takes the item out of the pickup index
+			Item->StartItemCurve(this);
+			PickupSound = PickupSound ? PickupSound : Item->GetPickupSound();
+		}
 	}
 
-	else
+	if (PickupSound)
 	{
-		OverlappedItemCount += Amount;
-		charShouldTraceForItems = true;
+		ClientPlayPickupSound(PickupSound);
 	}
 }
 
-FVector AMainCharacter::GetCameraInterpLocation()
+void AMainCharacter::FinishReloading()
+{
+	// Clients play the montage too, but the ammo moves on the server
+	if (!HasAuthority()) return;
+
+	CombatState = ECombatState::ECS_Unoccupied;
+
+	if (EquipWeapon == nullptr) return;
+
+	const int32 MagazineEmptySpace = EquipWeapon->GetMagazineCapacity() -
+		EquipWeapon->GetAmmo();
+
+	EquipWeapon->ReloadAmmo(Inventory->TakeAmmo(EquipWeapon->GetAmmoType(), MagazineEmptySpace));
+}
+
+int32 AMainCharacter::GetNumActiveTimers() const
+{
+	return GetWorldTimerManager().IsTimerActive(FireTimer);
+}
+
+FVector AMainCharacter::GetCameraInterpLocation() const
 {
 	const FVector CameraWorldLocation{ FollowCamera->GetComponentLocation() };
 	const FVector CameraForward{ FollowCamera->GetForwardVector() };
@@ -785,10 +1120,9 @@ void AMainCharacter::GetPickupItem(AItem* Item)
 	auto Weapon = Cast<AWeapon>(Item);
 	if (Weapon)
 	{
-		if (Inventory.Num() < INVENTORY_CAPACITY)
+		if (!Inventory->IsFull())
 		{
-			Weapon->SetSlotIndex(Inventory.Num());
-			Inventory.Add(Weapon);
+			Inventory->AddItem(Weapon);
 			Weapon->SetItemState(EItemState::EIS_PickedUp);
 		}
 		else
@@ -9,6 +9,10 @@
 
 
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FCharacterHealthChangedSignature, float, Health, float, MaxHealth);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FEquippedWeaponChangedSignature, class AWeapon*, Weapon);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FMainCharacterEquipWeapon, class AMainCharacter*, class AWeapon*, class AWeapon*);
+
 UENUM(BlueprintType)
 enum class ECombatState : uint8
 {
@@ -24,6 +28,9 @@ class ZOMBIETEAMPROJECT_API AMainCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
+	/** Bots drive the character through the same handlers as player input */
+	friend class ABotPlayerController;
+
 public:
 	AMainCharacter();
 
@@ -63,7 +70,7 @@ protected:
 
 	/** This function is called when the character fires the weapon */
 	void FireWeapon();
-	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult);
+	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, TArray<FHitResult>& OutHitResults, FVector& OutBeamEndLocation);
 
 	/** Functions used for aiming at the enemies */
 	void AimingButtonPressed();
@@ -77,8 +84,26 @@ protected:
 	UFUNCTION()
 		void AutoFireReset();
 
-	/** Line trace for items when aiming with crosshair */
-	bool TraceWidgetUnderCrosshair(FHitResult& OutHitResult, FVector& OutHitLocation);
+	/**
+	 * World ray through the crosshair. Remote players on the server have no
+	 * viewport, so their ray is the one their client deprojected while firing,
+	 * as long as it stays close to the camera view the client last sent.
+	 */
+	bool GetCrosshairRay(FVector& OutStart, FVector& OutDirection) const;
+
+	/**
+	 * How far back the server rewinds enemies for this character's shots: the
+	 * remote player's round trip, capped by the hitscan history. Zero for
+	 * locally controlled characters.
+	 */
+	float GetShotRewindTime() const;
+
+	/** Line trace under the crosshair on the given channel (bullets or interactables) */
+	bool TraceWidgetUnderCrosshair(
+		FHitResult& OutHitResult,
+		FVector& OutHitLocation,
+		ECollisionChannel TraceChannel,
+		const FCollisionResponseParams& ResponseParams = FCollisionResponseParams::DefaultResponseParam);
 
 	void TraceForItems();
 
@@ -93,36 +118,90 @@ protected:
 
 	void SwapWeapon(AWeapon* WeaponToSwap);
 
-	void InitializeAmmoMap();
-
 	bool WeaponHasAmmo();
 
-	void FKeyPressed();
-	void OneKeyPressed();
-	void TwoKeyPressed();
-	void ThreeKeyPressed();
-	void FourKeyPressed();
-	void FiveKeyPressed();
+	/** Bound to the slot keys; F selects slot 0, 1-5 select slots 1 to 5 */
+	void SelectInventorySlot(int32 SlotIndex);
 
-	void ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex);
+	/** Equip the weapon in the newly active inventory slot */
+	UFUNCTION()
+	void OnActiveSlotChanged(int32 PreviousSlotIndex, int32 NewSlotIndex);
 
 	void PlayFireSound();
 	void SendBullet();
+
+	/**
+	 * Apply damage for one shot, stopping once the weapon's penetration is used up.
+	 * Returns true if the bullet stopped in the world at OutImpactLocation.
+	 */
+	bool ApplyBulletHits(const TArray<FHitResult>& BeamHitResults, FVector& OutBeamEndLocation, FVector& OutImpactLocation);
+
+	/** Muzzle flash, beam, impact, sound and fire montage for everyone who can see the shot */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastFireEffects(FVector_NetQuantize BeamEndLocation, bool bDrawBeam, FVector_NetQuantize ImpactLocation, bool bSpawnImpact);
+
+	/** Damage numbers are only shown to the player who fired */
+	void ShowHitNumber(class AEnemy* HitEnemy, int32 Damage, const FVector& HitLocation);
+
+	UFUNCTION(Client, Unreliable)
+	void ClientShowHitNumber(AEnemy* HitEnemy, int32 Damage, FVector_NetQuantize HitLocation);
+
 	void PlayGunFireMontage();
 
 	void ReloadButtonPressed();
 
 	void ReloadWeapon();
 
+	void PlayReloadMontage();
+
+	/** Pick up the item if it is still lying in reach; server only */
+	void InteractWithItem(AItem* Item);
+
+	/** Pickup sound for the owning player, sent once the server has accepted the pickup */
+	UFUNCTION(Client, Unreliable)
+	void ClientPlayPickupSound(USoundCue* Sound);
+
+	/** Input that changes gameplay state is forwarded to the server; fire presses carry the crosshair ray */
+	UFUNCTION(Server, Reliable)
+	void ServerSetFireButton(bool bPressed, FVector_NetQuantize AimStart, FVector_NetQuantizeNormal AimDirection);
+
+	/** Keep the server's copy of the crosshair ray current while the fire button is held */
+	UFUNCTION(Server, Unreliable)
+	void ServerSetAimRay(FVector_NetQuantize AimStart, FVector_NetQuantizeNormal AimDirection);
+
+	UFUNCTION(Server, Reliable)
+	void ServerSetAiming(bool bAiming);
+
+	UFUNCTION(Server, Reliable)
+	void ServerReload();
+
+	UFUNCTION(Server, Reliable)
+	void ServerInteract(AItem* Item);
+
+	UFUNCTION(Server, Reliable)
+	void ServerSelectInventorySlot(int32 SlotIndex);
+
 	bool CarriedAmmo();
 
 	void PickupAmmo(class AAmmo* Ammo);
 
+	/** Pull every ammo pickup within AmmoMagnetRadius towards the character */
+	void AttractNearbyAmmo();
+
 	void MainCharacterDeath();
 
 	UFUNCTION(BlueprintCallable)
 	void FinishDeath();
 
+	UFUNCTION()
+	void OnRep_Health();
+
+	UFUNCTION()
+	void OnRep_EquipWeapon();
+
+	UFUNCTION()
+	void OnRep_CombatState();
+
 public:
 	//Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -130,6 +209,8 @@ public:
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	// End of APawn interface
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 private:
 	/** Camera boom positioning the camera behind the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -161,7 +242,7 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		UParticleSystem* BeamParticles;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		bool isAiming;
 
 	/** Camera field of view value */
@@ -172,6 +253,18 @@ private:
 	/** This is to check if the left mouse button is pressed */
 	bool isFireButtonPressed;
 
+	/** Crosshair ray a remote client last sent while firing; server only */
+	FVector RemoteAimStart;
+	FVector RemoteAimDirection;
+	bool bHasRemoteAimRay;
+
+	/** How far a client's crosshair ray may stray from its camera view before the server falls back on the view */
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float MaxRemoteAimAngle;
+
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+		float MaxRemoteAimOffset;
+
 	/** This is to check 2 things, whether the character can fire or wait for the timer*/
 	bool charShouldFire;
 
@@ -181,14 +274,13 @@ private:
 	/** This is a timer between shots */
 	FTimerHandle FireTimer;
 
+	/** True while any pickup is in range; refreshed every frame from the pickup index */
 	bool charShouldTraceForItems;
 
-	int8 OverlappedItemCount;
-
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 		class AItem* TraceHitItemLastFrame;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_EquipWeapon, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		AWeapon* EquipWeapon;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -203,17 +295,18 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 		float CameraInterpElevation;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-		TMap<EAmmoType, int32> AmmoMap;
-
+	/** Automatically pick up ammo that comes within AmmoMagnetRadius */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
-		int32 Starting9mmAmmo;
+		bool bAutoPickupAmmo;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
+		float AmmoMagnetRadius;
 
+	/** Extra distance beyond an item's pickup radius the server accepts, to absorb latency */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Items, meta = (AllowPrivateAccess = "true"))
-		int32 StartingARAmmo;
+		float InteractDistanceTolerance;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_CombatState, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		ECombatState CombatState;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -222,13 +315,12 @@ private:
 	UFUNCTION(BlueprintCallable)
 		void FinishReloading();
 
+	/** Weapon slots and carried ammo */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
-		TArray<AItem*> Inventory;
-
-	const int32 INVENTORY_CAPACITY{ 6 };
+		class UInventoryComponent* Inventory;
 
 	/** Character health */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_Health, Category = Combat, meta = (AllowPrivateAccess = "true"))
 		float Health;
 
 	/** Character max health */
@@ -247,13 +339,28 @@ public:
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
 
 	FORCEINLINE bool GetAiming() const { return isAiming; }
+	FORCEINLINE ECombatState GetCombatState() const { return CombatState; }
 
-	FORCEINLINE int8 GetOverlappedItemCount() const { return OverlappedItemCount; }
-
-	void IncrementOverlappedItemCount(int8 Amount);
-	FVector GetCameraInterpLocation();
+	FVector GetCameraInterpLocation() const;
 	void GetPickupItem(AItem* Item);
 
 	FORCEINLINE AWeapon* GetEquipWeapon() const { return EquipWeapon; }
+	FORCEINLINE UInventoryComponent* GetInventory() const { return Inventory; }
+	FORCEINLINE float GetBaseTurnRate() const { return BaseTurnRate; }
+	FORCEINLINE float GetBaseLookUpRate() const { return BaseLookUpRate; }
+
+	/** Pending gameplay timers, for telemetry */
+	int32 GetNumActiveTimers() const;
+	FORCEINLINE float GetHealth() const { return Health; }
+	FORCEINLINE float GetMaxHealth() const { return MaxHealth; }
+
+	UPROPERTY(BlueprintAssignable, Category = Combat)
+	FCharacterHealthChangedSignature OnHealthChanged;
+
+	UPROPERTY(BlueprintAssignable, Category = Combat)
+	FEquippedWeaponChangedSignature OnEquippedWeaponChanged;
+
+	/** Fired on the server for any character with (character, previous weapon, new weapon) */
+	static FMainCharacterEquipWeapon NotifyEquipWeapon;
 };
 
@@ -6,9 +6,12 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Weapon.h"
 #include "WeaponType.h"
+#include "ZombieTeamProject.h"
 
 void UMainCharacterAnimInstance::UpdateAnimationProperties(float DeltaTime)
 {
+	if (!bUpdateCosmetics) return;
+
 	if (MainCharacter == nullptr)
 	{
 		MainCharacter = Cast<AMainCharacter>(TryGetPawnOwner());
@@ -44,4 +47,5 @@ void UMainCharacterAnimInstance::UpdateAnimationProperties(float DeltaTime)
 void UMainCharacterAnimInstance::NativeInitializeAnimation()
 {
 	MainCharacter = Cast<AMainCharacter>(TryGetPawnOwner());
+	bUpdateCosmetics = ShouldPlayCosmetics(this);
 }
@@ -22,6 +22,9 @@ public:
 	virtual void NativeInitializeAnimation() override;
 
 private:
+	/** Locomotion properties only feed the pose, which nobody sees without a viewport */
+	bool bUpdateCosmetics;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	class AMainCharacter* MainCharacter;
 
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MainHUD.h"
+#include "Engine/Canvas.h"
+#include "Engine/Texture2D.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "MainCharacter.h"
+#include "Weapon.h"
+
+AMainHUD::AMainHUD() :
+	CrosshairSpreadMax(16.f),
+	CrosshairOffset(FVector2D(0.f, -50.f)),
+	CrosshairSpreadMultiplier(0.f),
+	CrosshairVelocityFactor(0.f),
+	CrosshairInAirFactor(0.f),
+	CrosshairAimFactor(0.f),
+	CrosshairShootingFactor(0.f)
+{
+
+}
+
+void AMainHUD::DrawHUD()
+{
+	Super::DrawHUD();
+
+	const AMainCharacter* Character = Cast<AMainCharacter>(GetOwningPawn());
+	if (Character == nullptr || Character->GetEquipWeapon() == nullptr) return;
+
+	UpdateCrosshairSpread(Character, GetWorld()->GetDeltaSeconds());
+	DrawCrosshair(Character->GetEquipWeapon());
+}
+
+void AMainHUD::UpdateCrosshairSpread(const AMainCharacter* Character, float DeltaTime)
+{
+	const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+
+	// Ground speed maps to 0..1 of the walk speed
+	FVector Velocity{ Character->GetVelocity() };
+	Velocity.Z = 0.f;
+	CrosshairVelocityFactor = FMath::GetMappedRangeValueClamped(
+		FVector2D(0.f, Movement->MaxWalkSpeed),
+		FVector2D(0.f, 1.f),
+		Velocity.Size());
+
+	CrosshairInAirFactor = Movement->IsFalling() ?
+		FMath::FInterpTo(CrosshairInAirFactor, 2.25f, DeltaTime, 2.25f) :
+		FMath::FInterpTo(CrosshairInAirFactor, 0.f, DeltaTime, 30.f);
+
+	CrosshairAimFactor = Character->GetAiming() ?
+		FMath::FInterpTo(CrosshairAimFactor, 0.6f, DeltaTime, 30.f) :
+		FMath::FInterpTo(CrosshairAimFactor, 0.f, DeltaTime, 30.f);
+
+	CrosshairShootingFactor = Character->GetCombatState() == ECombatState::ECS_FireTimerInProgress ?
+		FMath::FInterpTo(CrosshairShootingFactor, 0.3f, DeltaTime, 60.f) :
+		FMath::FInterpTo(CrosshairShootingFactor, 0.f, DeltaTime, 60.f);
+
+	CrosshairSpreadMultiplier = 0.5f +
+		CrosshairVelocityFactor +
+		CrosshairInAirFactor -
+		CrosshairAimFactor +
+		CrosshairShootingFactor;
+}
+
+void AMainHUD::DrawCrosshair(const AWeapon* Weapon)
+{
+	if (Canvas == nullptr) return;
+
+	const FCrosshairAtlas& Atlas = Weapon->GetCrosshairs();
+	UTexture2D* Texture = Atlas.Texture;
+	const FVector2D Center{ Canvas->ClipX * 0.5f + CrosshairOffset.X, Canvas->ClipY * 0.5f + CrosshairOffset.Y };
+	const float Spread{ CrosshairSpreadMax * CrosshairSpreadMultiplier };
+
+	const FVector2D PieceOffsets[]
+	{
+		FVector2D(0.f, 0.f),
+		FVector2D(-Spread, 0.f),
+		FVector2D(Spread, 0.f),
+		FVector2D(0.f, -Spread),
+		FVector2D(0.f, Spread),
+	};
+	static_assert(UE_ARRAY_COUNT(PieceOffsets) == static_cast<uint8>(ECrosshairPiece::ECP_MAX), "One offset per crosshair piece");
+
+	if (Texture == nullptr)
+	{
+		const FName WeaponClassName{ Weapon->GetClass()->GetFName() };
+		if (!WeaponsWithoutAtlas.Contains(WeaponClassName))
+		{
+			WeaponsWithoutAtlas.Add(WeaponClassName);
+			UE_LOG(LogTemp, Warning, TEXT("%s has no crosshair atlas; drawing its separate crosshair textures"), *WeaponClassName.ToString());
+		}
+
+		// One draw per piece until the weapon's atlas is authored
+		for (uint8 Piece = 0; Piece < static_cast<uint8>(ECrosshairPiece::ECP_MAX); ++Piece)
+		{
+			UTexture2D* PieceTexture = Weapon->GetCrosshairPieceTexture(static_cast<ECrosshairPiece>(Piece));
+			if (PieceTexture == nullptr) continue;
+
+			const FVector2D PieceSize{ static_cast<float>(PieceTexture->GetSizeX()), static_cast<float>(PieceTexture->GetSizeY()) };
+			const FVector2D PieceLocation{ Center + PieceOffsets[Piece] - PieceSize * 0.5f };
+			DrawTexture(
+				PieceTexture,
+				PieceLocation.X, PieceLocation.Y,
+				PieceSize.X, PieceSize.Y,
+				0.f, 0.f,
+				1.f, 1.f);
+		}
+		return;
+	}
+
+	const FVector2D TextureSize{ static_cast<float>(Texture->GetSizeX()), static_cast<float>(Texture->GetSizeY()) };
+
+	// Every piece shares the atlas texture, so the canvas merges these tiles into one batch
+	for (uint8 Piece = 0; Piece < static_cast<uint8>(ECrosshairPiece::ECP_MAX); ++Piece)
+	{
+		const FCrosshairAtlasRegion& Region = Atlas.Regions[Piece];
+		const FVector2D PieceSize{ Region.UVSize * TextureSize };
+		const FVector2D PieceLocation{ Center + PieceOffsets[Piece] - PieceSize * 0.5f };
+
+		DrawTexture(
+			Texture,
+			PieceLocation.X, PieceLocation.Y,
+			PieceSize.X, PieceSize.Y,
+			Region.UV.X, Region.UV.Y,
+			Region.UVSize.X, Region.UVSize.Y);
+	}
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "MainHUD.generated.h"
+
+/**
+ * Draws the equipped weapon's crosshair from its atlas. All five pieces come
+ * from one texture, so the canvas batches them into a single draw. Weapons
+ * without an atlas yet fall back on their five separate textures.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API AMainHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	AMainHUD();
+
+	virtual void DrawHUD() override;
+
+protected:
+	/** Blend the spread factors towards the character's current movement, aim and fire state */
+	void UpdateCrosshairSpread(const class AMainCharacter* Character, float DeltaTime);
+
+	void DrawCrosshair(const class AWeapon* Weapon);
+
+private:
+	/** Spread in pixels at a multiplier of 1 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	float CrosshairSpreadMax;
+
+	/** Screen offset of the crosshair from the viewport centre, matching the aim trace */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	FVector2D CrosshairOffset;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshair, meta = (AllowPrivateAccess = "true"))
+	float CrosshairSpreadMultiplier;
+
+	float CrosshairVelocityFactor;
+	float CrosshairInAirFactor;
+	float CrosshairAimFactor;
+	float CrosshairShootingFactor;
+
+	/** Weapon classes already reported as missing a crosshair atlas */
+	TSet<FName> WeaponsWithoutAtlas;
+};
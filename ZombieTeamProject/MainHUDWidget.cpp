@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MainHUDWidget.h"
+#include "MainCharacter.h"
+#include "InventoryComponent.h"
+#include "Weapon.h"
+
+void UMainHUDWidget::BindToCharacter(AMainCharacter* Character)
+{
+	if (Character == BoundCharacter) return;
+
+	UnbindFromCharacter();
+	BoundCharacter = Character;
+	if (BoundCharacter == nullptr) return;
+
+	BoundCharacter->OnHealthChanged.AddDynamic(this, &UMainHUDWidget::OnHealthChanged);
+	BoundCharacter->OnEquippedWeaponChanged.AddDynamic(this, &UMainHUDWidget::HandleEquippedWeaponChanged);
+
+	UInventoryComponent* Inventory = BoundCharacter->GetInventory();
+	Inventory->OnAmmoChanged.AddDynamic(this, &UMainHUDWidget::OnCarriedAmmoChanged);
+	Inventory->OnSlotChanged.AddDynamic(this, &UMainHUDWidget::OnInventorySlotChanged);
+	Inventory->OnActiveSlotChanged.AddDynamic(this, &UMainHUDWidget::OnActiveSlotChanged);
+
+	// Push the current state once; from here on only changes are sent
+	OnHealthChanged(BoundCharacter->GetHealth(), BoundCharacter->GetMaxHealth());
+	for (uint8 AmmoIndex = 0; AmmoIndex < static_cast<uint8>(EAmmoType::EAT_MAX); ++AmmoIndex)
+	{
+		const EAmmoType AmmoType{ static_cast<EAmmoType>(AmmoIndex) };
+		OnCarriedAmmoChanged(AmmoType, Inventory->GetAmmo(AmmoType));
+	}
+	for (int32 SlotIndex = 0; SlotIndex < UInventoryComponent::INVENTORY_CAPACITY; ++SlotIndex)
+	{
+		OnInventorySlotChanged(SlotIndex, Inventory->GetItemAt(SlotIndex));
+	}
+	OnActiveSlotChanged(Inventory->GetActiveSlot(), Inventory->GetActiveSlot());
+	HandleEquippedWeaponChanged(BoundCharacter->GetEquipWeapon());
+}
+
+void UMainHUDWidget::UnbindFromCharacter()
+{
+	if (BoundWeapon)
+	{
+		BoundWeapon->OnAmmoChanged.RemoveAll(this);
+		BoundWeapon = nullptr;
+	}
+
+	if (BoundCharacter)
+	{
+		BoundCharacter->OnHealthChanged.RemoveAll(this);
+		BoundCharacter->OnEquippedWeaponChanged.RemoveAll(this);
+		BoundCharacter->GetInventory()->OnAmmoChanged.RemoveAll(this);
+		BoundCharacter->GetInventory()->OnSlotChanged.RemoveAll(this);
+		BoundCharacter->GetInventory()->OnActiveSlotChanged.RemoveAll(this);
+		BoundCharacter = nullptr;
+	}
+}
+
+void UMainHUDWidget::HandleEquippedWeaponChanged(AWeapon* Weapon)
+{
+	if (BoundWeapon)
+	{
+		BoundWeapon->OnAmmoChanged.RemoveAll(this);
+	}
+
+	BoundWeapon = Weapon;
+	if (BoundWeapon)
+	{
+		BoundWeapon->OnAmmoChanged.AddDynamic(this, &UMainHUDWidget::OnWeaponAmmoChanged);
+		OnWeaponAmmoChanged(BoundWeapon->GetAmmo(), BoundWeapon->GetMagazineCapacity());
+	}
+
+	OnEquippedWeaponChanged(BoundWeapon);
+}
+
+void UMainHUDWidget::NativeDestruct()
+{
+	UnbindFromCharacter();
+
+	Super::NativeDestruct();
+}
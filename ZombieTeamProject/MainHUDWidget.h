@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "AmmoType.h"
+#include "MainHUDWidget.generated.h"
+
+/**
+ * Base class for the player HUD. Values are pushed through the events below
+ * when the character, its weapon or its inventory change, so the widget
+ * needs no per-frame property bindings and its panels can stay inside an
+ * invalidation box.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UMainHUDWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/** Subscribe to the character's change events and push the current values */
+	void BindToCharacter(class AMainCharacter* Character);
+
+protected:
+	virtual void NativeDestruct() override;
+
+	UFUNCTION(BlueprintImplementableEvent, Category = HUD)
+	void OnHealthChanged(float Health, float MaxHealth);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = HUD)
+	void OnWeaponAmmoChanged(int32 Ammo, int32 MagazineCapacity);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = HUD)
+	void OnCarriedAmmoChanged(EAmmoType AmmoType, int32 AmmoCount);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = HUD)
+	void OnEquippedWeaponChanged(class AWeapon* Weapon);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = HUD)
+	void OnInventorySlotChanged(int32 SlotIndex, class AItem* Item);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = HUD)
+	void OnActiveSlotChanged(int32 PreviousSlotIndex, int32 NewSlotIndex);
+
+private:
+	/** Move the ammo subscription to the newly equipped weapon */
+	UFUNCTION()
+	void HandleEquippedWeaponChanged(AWeapon* Weapon);
+
+	void UnbindFromCharacter();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = HUD, meta = (AllowPrivateAccess = "true"))
+	AMainCharacter* BoundCharacter;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = HUD, meta = (AllowPrivateAccess = "true"))
+	AWeapon* BoundWeapon;
+};
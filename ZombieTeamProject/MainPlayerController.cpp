@@ -3,17 +3,41 @@
 
 #include "MainPlayerController.h"
 #include "Blueprint/UserWidget.h"
+#include "MainHUDWidget.h"
+#include "MainCharacter.h"
+#include "HealthBarLayerWidget.h"
+#include "InventoryComponent.h"
+#include "Components/InputComponent.h"
+#include "GameFramework/PlayerInput.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
 
-AMainPlayerController::AMainPlayerController()
+AMainPlayerController::AMainPlayerController() :
+	HealthBarLayerClass(UHealthBarLayerWidget::StaticClass()),
+	RecordTime(0.f)
 {
-
+	for (float& Value : RecordedValues)
+	{
+		Value = 0.f;
+	}
 }
 
 void AMainPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (HUDOverlayClass)
+	if (HealthBarLayerClass && IsLocalController())
+	{
+		HealthBarLayer = CreateWidget<UHealthBarLayerWidget>(this, HealthBarLayerClass);
+
+		if (HealthBarLayer)
+		{
+			// Below the HUD overlay
+			HealthBarLayer->AddToViewport(-1);
+		}
+	}
+
+	if (HUDOverlayClass && IsLocalController())
 	{
 		HUDOverlay = CreateWidget<UUserWidget>(this, HUDOverlayClass);
 
@@ -21,6 +45,102 @@ void AMainPlayerController::BeginPlay()
 		{
 			HUDOverlay->AddToViewport();
 			HUDOverlay->SetVisibility(ESlateVisibility::Visible);
+			BindHUDToPawn();
 		}
 	}
+
+	// Bots replay timelines rather than record them
+	if (IsLocalPlayerController() && !FParse::Param(FCommandLine::Get(), TEXT("BotPlayer"))
+		&& FParse::Value(FCommandLine::Get(), TEXT("BotRecord="), BotRecordPath)
+		&& FPaths::IsRelative(BotRecordPath))
+	{
+		BotRecordPath = FPaths::Combine(FPaths::ProjectDir(), BotRecordPath);
+	}
+}
+
+void AMainPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (!BotRecordPath.IsEmpty())
+	{
+		if (!UBotInputTimeline::SaveEventsToCsv(BotRecordPath, RecordedEvents))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Bot timeline %s could not be written"), *BotRecordPath);
+		}
+		BotRecordPath.Empty();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AMainPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	if (!BotRecordPath.IsEmpty())
+	{
+		RecordBotInput(DeltaTime);
+	}
+}
+
+void AMainPlayerController::RecordBotInput(float DeltaTime)
+{
+	RecordTime += DeltaTime;
+
+	const AMainCharacter* Character = Cast<AMainCharacter>(GetPawn());
+	if (Character == nullptr || Character->InputComponent == nullptr) return;
+
+	auto Record = [this](EBotInput Input, float Value, float Threshold)
+	{
+		float& Recorded = RecordedValues[static_cast<uint8>(Input)];
+		if (FMath::Abs(Value - Recorded) <= Threshold) return;
+
+		Recorded = Value;
+		FBotInputEvent& Event = RecordedEvents.AddDefaulted_GetRef();
+		Event.Time = RecordTime;
+		Event.Input = Input;
+		Event.Value = Value;
+	};
+
+	// Mouse look arrives as a per-frame delta; bots turn at a rate, so convert it
+	const UInputComponent* PawnInput = Character->InputComponent;
+	const float TurnRate{ PawnInput->GetAxisValue(TEXT("TurnRate")) + (DeltaTime > 0.f && Character->GetBaseTurnRate() > 0.f
+		? PawnInput->GetAxisValue(TEXT("Turn")) / (Character->GetBaseTurnRate() * DeltaTime) : 0.f) };
+	const float LookUpRate{ PawnInput->GetAxisValue(TEXT("LookUpRate")) + (DeltaTime > 0.f && Character->GetBaseLookUpRate() > 0.f
+		? PawnInput->GetAxisValue(TEXT("LookUp")) / (Character->GetBaseLookUpRate() * DeltaTime) : 0.f) };
+
+	Record(EBotInput::EBI_MoveForward, PawnInput->GetAxisValue(TEXT("MoveForward")), 0.01f);
+	Record(EBotInput::EBI_MoveRight, PawnInput->GetAxisValue(TEXT("MoveRight")), 0.01f);
+	Record(EBotInput::EBI_Turn, TurnRate, 0.01f);
+	Record(EBotInput::EBI_LookUp, LookUpRate, 0.01f);
+	Record(EBotInput::EBI_Fire, IsActionHeld(TEXT("FireButton")) ? 1.f : 0.f, 0.f);
+	Record(EBotInput::EBI_Aim, IsActionHeld(TEXT("AimingButton")) ? 1.f : 0.f, 0.f);
+	Record(EBotInput::EBI_Interact, IsActionHeld(TEXT("InteractButton")) ? 1.f : 0.f, 0.f);
+	Record(EBotInput::EBI_Reload, IsActionHeld(TEXT("ReloadButton")) ? 1.f : 0.f, 0.f);
+	Record(EBotInput::EBI_SelectSlot, static_cast<float>(Character->GetInventory()->GetActiveSlot()), 0.f);
+}
+
+bool AMainPlayerController::IsActionHeld(FName ActionName) const
+{
+	if (PlayerInput == nullptr) return false;
+
+	for (const FInputActionKeyMapping& Mapping : PlayerInput->GetKeysForAction(ActionName))
+	{
+		if (IsInputKeyDown(Mapping.Key)) return true;
+	}
+	return false;
+}
+
+void AMainPlayerController::SetPawn(APawn* InPawn)
+{
+	Super::SetPawn(InPawn);
+
+	BindHUDToPawn();
+}
+
+void AMainPlayerController::BindHUDToPawn()
+{
+	if (UMainHUDWidget* MainHUD = Cast<UMainHUDWidget>(HUDOverlay))
+	{
+		MainHUD->BindToCharacter(Cast<AMainCharacter>(GetPawn()));
+	}
 }
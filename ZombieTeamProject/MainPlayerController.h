@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "BotInputTimeline.h"
 #include "MainPlayerController.generated.h"
 
 /**
@@ -19,10 +20,41 @@ public:
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void SetPawn(APawn* InPawn) override;
+
+	virtual void PlayerTick(float DeltaTime) override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Point the HUD at the currently controlled character */
+	void BindHUDToPawn();
+
+	/** Append this frame's input changes on the controlled character to the recorded bot timeline */
+	void RecordBotInput(float DeltaTime);
+
+	/** Whether any key mapped to the action is down */
+	bool IsActionHeld(FName ActionName) const;
+
 private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<class UUserWidget> HUDOverlayClass;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
 	UUserWidget* HUDOverlay;
+
+	/** Layer that draws every enemy health bar */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class UHealthBarLayerWidget> HealthBarLayerClass;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	UHealthBarLayerWidget* HealthBarLayer;
+
+	/** -BotRecord=<csv>: the player's input is saved there as a bot timeline when play ends */
+	FString BotRecordPath;
+
+	TArray<FBotInputEvent> RecordedEvents;
+	float RecordTime;
+
+	/** Last recorded value of each input, so only changes become events */
+	float RecordedValues[static_cast<uint8>(EBotInput::EBI_MAX)];
 };
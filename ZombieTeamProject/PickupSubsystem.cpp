@@ -0,0 +1,210 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupSubsystem.h"
+#include "Item.h"
+#include "MainCharacter.h"
+#include "Curves/CurveFloat.h"
+#include "ZombieTeamProject.h"
+
+namespace
+{
+	/** Edge length of a grid cell; about the size of the largest pickup radius */
+	constexpr float PickupCellSize{ 500.f };
+}
+
+static TAutoConsoleVariable<int32> CVarMaxFallingItems(
+	TEXT("zombie.Item.MaxFallingItems"),
+	8,
+	TEXT("Maximum number of dropped items simulating physics at once; the oldest are settled beyond this."));
+
+FIntPoint UPickupSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt(Location.X / PickupCellSize),
+		FMath::FloorToInt(Location.Y / PickupCellSize));
+}
+
+template<typename FuncType>
+bool UPickupSubsystem::ForEachPickupNear(const FVector& Location, float Radius, FuncType Func) const
+{
+	const FIntPoint MinCell{ GetCell(Location - FVector(Radius)) };
+	const FIntPoint MaxCell{ GetCell(Location + FVector(Radius)) };
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const TArray<AItem*>* Items = Cells.Find(FIntPoint(X, Y));
+			if (Items == nullptr) continue;
+
+			for (AItem* Item : *Items)
+			{
+				if (Func(Item)) return true;
+			}
+		}
+	}
+	return false;
+}
+
+void UPickupSubsystem::RegisterPickup(AItem* Item)
+{
+	if (Item == nullptr) return;
+
+	const FIntPoint Cell{ GetCell(Item->GetActorLocation()) };
+	if (FIntPoint* CurrentCell = ItemCells.Find(Item))
+	{
+		if (*CurrentCell == Cell) return;
+		UnregisterPickup(Item);
+	}
+
+	Cells.FindOrAdd(Cell).Add(Item);
+	ItemCells.Add(Item, Cell);
+	MaxPickupRadius = FMath::Max(MaxPickupRadius, Item->GetPickupRadius());
+}
+
+void UPickupSubsystem::UnregisterPickup(AItem* Item)
+{
+	FIntPoint Cell;
+	if (!ItemCells.RemoveAndCopyValue(Item, Cell)) return;
+
+	TArray<AItem*>& Items = Cells.FindChecked(Cell);
+	Items.RemoveSingleSwap(Item, false);
+	if (Items.Num() == 0)
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+bool UPickupSubsystem::IsAnyPickupInRange(const FVector& Location) const
+{
+	return ForEachPickupNear(Location, MaxPickupRadius, [&Location](const AItem* Item)
+	{
+		return FVector::DistSquared(Item->GetActorLocation(), Location) <= FMath::Square(Item->GetPickupRadius());
+	});
+}
+
+void UPickupSubsystem::GatherPickupsInRadius(const FVector& Location, float Radius, TArray<AItem*>& OutItems) const
+{
+	const float RadiusSquared{ FMath::Square(Radius) };
+	ForEachPickupNear(Location, Radius, [&Location, &OutItems, RadiusSquared](AItem* Item)
+	{
+		if (FVector::DistSquared(Item->GetActorLocation(), Location) <= RadiusSquared)
+		{
+			OutItems.Add(Item);
+		}
+		return false;
+	});
+}
+
+void UPickupSubsystem::RegisterFallingItem(AItem* Item)
+{
+	if (Item == nullptr) return;
+
+	FallingItems.AddUnique(Item);
+
+	const int32 MaxFallingItems{ FMath::Max(CVarMaxFallingItems.GetValueOnGameThread(), 0) };
+	while (FallingItems.Num() > MaxFallingItems)
+	{
+		// Settling unregisters the item, so take it off the list first
+		AItem* Oldest = FallingItems[0].Get();
+		FallingItems.RemoveAt(0, 1, false);
+		if (Oldest)
+		{
+			Oldest->Settle();
+		}
+	}
+}
+
+void UPickupSubsystem::UnregisterFallingItem(AItem* Item)
+{
+	FallingItems.Remove(Item);
+}
+
+void UPickupSubsystem::StartItemInterp(AItem* Item, AMainCharacter* Character)
+{
+	if (Item == nullptr) return;
+
+	ItemInterps.Add({ Item, Character, Item->GetActorLocation(), 0.f });
+}
+
+void UPickupSubsystem::UpdateItemInterps(float DeltaTime)
+{
+	ZOMBIE_SCOPE_CYCLE_COUNTER(STAT_ItemInterp);
+
+	// Camera targets are computed once per character, not once per item
+	TArray<TPair<const AMainCharacter*, FVector>, TInlineAllocator<4>> CameraTargets;
+	TArray<AItem*, TInlineAllocator<8>> FinishedItems;
+
+	for (int32 Index = ItemInterps.Num() - 1; Index >= 0; --Index)
+	{
+		FItemInterp& Interp = ItemInterps[Index];
+		AItem* Item = Interp.Item.Get();
+		const AMainCharacter* Character = Interp.Character.Get();
+		if (Item == nullptr || Character == nullptr)
+		{
+			ItemInterps.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		Interp.ElapsedTime += DeltaTime;
+		if (Interp.ElapsedTime >= Item->GetZCurveTime())
+		{
+			FinishedItems.Add(Item);
+			ItemInterps.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const UCurveFloat* ZCurve = Item->GetItemZCurve();
+		if (ZCurve == nullptr) continue;
+
+		const TPair<const AMainCharacter*, FVector>* CameraTarget = CameraTargets.FindByPredicate(
+			[Character](const TPair<const AMainCharacter*, FVector>& Target) { return Target.Key == Character; });
+		if (CameraTarget == nullptr)
+		{
+			CameraTarget = &CameraTargets.Emplace_GetRef(Character, Character->GetCameraInterpLocation());
+		}
+		const FVector& CameraInterpLocation = CameraTarget->Value;
+
+		const FVector CurrentLocation{ Item->GetActorLocation() };
+		const float DeltaZ{ FMath::Abs(CameraInterpLocation.Z - Interp.StartLocation.Z) };
+
+		FVector ItemLocation{ Interp.StartLocation };
+		ItemLocation.X = FMath::FInterpTo(CurrentLocation.X, CameraInterpLocation.X, DeltaTime, 30.f);
+		ItemLocation.Y = FMath::FInterpTo(CurrentLocation.Y, CameraInterpLocation.Y, DeltaTime, 30.f);
+		ItemLocation.Z += ZCurve->GetFloatValue(Interp.ElapsedTime) * DeltaZ;
+
+		// Collision is off while interping, so there is nothing to sweep against
+		Item->SetActorLocation(ItemLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	// Handing items over can start new interps, so finish them after the loop
+	for (AItem* Item : FinishedItems)
+	{
+		Item->FinishInterping();
+	}
+}
+
+void UPickupSubsystem::Tick(float DeltaTime)
+{
+	UpdateItemInterps(DeltaTime);
+}
+
+ETickableTickType UPickupSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UPickupSubsystem::IsTickable() const
+{
+	return ItemInterps.Num() > 0;
+}
+
+TStatId UPickupSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPickupSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UPickupSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
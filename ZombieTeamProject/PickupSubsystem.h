@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "PickupSubsystem.generated.h"
+
+/**
+ * Uniform grid of items lying in the world as pickups. Characters query it
+ * for nearby interactables instead of every item running its own overlap
+ * sphere. Items flying towards a character are moved here in one batch.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UPickupSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/** Add the item at its current location, or move it if already registered */
+	void RegisterPickup(class AItem* Item);
+	void UnregisterPickup(AItem* Item);
+
+	/** True when Location is within the pickup radius of any registered item */
+	bool IsAnyPickupInRange(const FVector& Location) const;
+
+	/** Collect the items whose location is within Radius of Location */
+	void GatherPickupsInRadius(const FVector& Location, float Radius, TArray<AItem*>& OutItems) const;
+
+	/**
+	 * Track an item that started simulating physics. When more items than
+	 * zombie.Item.MaxFallingItems are falling, the oldest ones are settled.
+	 */
+	void RegisterFallingItem(AItem* Item);
+	void UnregisterFallingItem(AItem* Item);
+
+	/** Fly the item along its Z curve to the character's camera, then hand it over */
+	void StartItemInterp(AItem* Item, class AMainCharacter* Character);
+
+private:
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Call Func for every item in the cells touching the sphere; stops when Func returns true */
+	template<typename FuncType>
+	bool ForEachPickupNear(const FVector& Location, float Radius, FuncType Func) const;
+
+	TMap<FIntPoint, TArray<AItem*>> Cells;
+
+	/** Cell each registered item was added to */
+	TMap<AItem*, FIntPoint> ItemCells;
+
+	/** Advance every interpolating item, sharing one camera target per character */
+	void UpdateItemInterps(float DeltaTime);
+
+	struct FItemInterp
+	{
+		TWeakObjectPtr<AItem> Item;
+		TWeakObjectPtr<AMainCharacter> Character;
+		FVector StartLocation;
+		float ElapsedTime;
+	};
+	TArray<FItemInterp> ItemInterps;
+
+	/** Falling items, oldest first */
+	TArray<TWeakObjectPtr<AItem>> FallingItems;
+
+	/** Largest pickup radius of any registered item, used to size range queries */
+	float MaxPickupRadius{ 0.f };
+};
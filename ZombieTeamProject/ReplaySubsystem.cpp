@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ReplaySubsystem.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	constexpr float ReplayBenchmarkHitchMs{ 33.3f };
+}
+
+void UReplaySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("RecordReplay="), RecordReplayName);
+	FParse::Value(CommandLine, TEXT("ReplayBenchmark="), BenchmarkReplayName);
+
+	if (IsBenchmarking())
+	{
+		// Every frame advances the replay by the same step, however long it took to run
+		int32 BenchmarkFPS{ 30 };
+		FParse::Value(CommandLine, TEXT("ReplayBenchmarkFPS="), BenchmarkFPS);
+		FApp::SetBenchmarking(true);
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(1.0 / FMath::Max(BenchmarkFPS, 1));
+	}
+
+	if (IsBenchmarking() || !RecordReplayName.IsEmpty())
+	{
+		PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UReplaySubsystem::OnPostLoadMap);
+	}
+}
+
+void UReplaySubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	if (bRecording)
+	{
+		GetGameInstance()->StopRecordingReplay();
+		bRecording = false;
+	}
+
+	Super::Deinitialize();
+}
+
+void UReplaySubsystem::OnPostLoadMap(UWorld* World)
+{
+	if (World == nullptr || World != GetGameInstance()->GetWorld()) return;
+
+	if (!RecordReplayName.IsEmpty() && !bRecording && World->GetNetMode() != NM_Client)
+	{
+		GetGameInstance()->StartRecordingReplay(RecordReplayName, RecordReplayName);
+		bRecording = true;
+	}
+
+	// Playing the replay loads its own map, which lands here again
+	if (IsBenchmarking() && !bPlaybackRequested)
+	{
+		bPlaybackRequested = GetGameInstance()->PlayReplay(BenchmarkReplayName);
+		if (!bPlaybackRequested)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Replay benchmark: could not play replay %s"), *BenchmarkReplayName);
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+void UReplaySubsystem::Tick(float DeltaTime)
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	UDemoNetDriver* DemoNetDriver = World ? World->GetDemoNetDriver() : nullptr;
+	if (DemoNetDriver == nullptr || !DemoNetDriver->IsPlaying())
+	{
+		LastFrameTime = 0.0;
+		return;
+	}
+
+	const double Now{ FPlatformTime::Seconds() };
+	if (LastFrameTime > 0.0)
+	{
+		FrameTimes.Add(static_cast<float>((Now - LastFrameTime) * 1000.0));
+	}
+	LastFrameTime = Now;
+
+	if (DemoNetDriver->GetDemoCurrentTime() >= DemoNetDriver->GetDemoTotalTime())
+	{
+		FinishBenchmark();
+	}
+}
+
+void UReplaySubsystem::FinishBenchmark()
+{
+	TArray<float> Sorted{ FrameTimes };
+	Sorted.Sort();
+
+	const int32 NumFrames{ Sorted.Num() };
+	auto Percentile = [&Sorted, NumFrames](float Fraction)
+	{
+		return NumFrames > 0 ? Sorted[FMath::Clamp(FMath::CeilToInt(Fraction * NumFrames) - 1, 0, NumFrames - 1)] : 0.f;
+	};
+
+	float TotalMs{ 0.f };
+	int32 NumHitches{ 0 };
+	for (const float FrameMs : Sorted)
+	{
+		TotalMs += FrameMs;
+		NumHitches += FrameMs > ReplayBenchmarkHitchMs;
+	}
+	const float AverageMs{ NumFrames > 0 ? TotalMs / NumFrames : 0.f };
+	const float MaxMs{ NumFrames > 0 ? Sorted.Last() : 0.f };
+
+	UE_LOG(LogTemp, Display, TEXT("Replay benchmark %s: %d frames, avg %.2f ms, median %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms, %d hitches"),
+		*BenchmarkReplayName, NumFrames, AverageMs, Percentile(0.5f), Percentile(0.95f), Percentile(0.99f), MaxMs, NumHitches);
+
+	const FString Report{ FString::Printf(
+		TEXT("Replay,Frames,AvgMs,MedianMs,P95Ms,P99Ms,MaxMs,Hitches\n%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d\n"),
+		*BenchmarkReplayName, NumFrames, AverageMs, Percentile(0.5f), Percentile(0.95f), Percentile(0.99f), MaxMs, NumHitches) };
+	const FString ReportPath{ FPaths::Combine(
+		FPaths::ProfilingDir(),
+		TEXT("ReplayBenchmark"),
+		FString::Printf(TEXT("%s_%s.csv"), *BenchmarkReplayName, *FDateTime::Now().ToString())) };
+	FFileHelper::SaveStringToFile(Report, *ReportPath);
+
+	BenchmarkReplayName.Empty();
+	FrameTimes.Empty();
+	FPlatformMisc::RequestExit(false);
+}
+
+ETickableTickType UReplaySubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UReplaySubsystem::IsTickable() const
+{
+	return IsBenchmarking() && bPlaybackRequested;
+}
+
+TStatId UReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UReplaySubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "ReplaySubsystem.generated.h"
+
+/**
+ * Records sessions with the replay system and plays them back as
+ * benchmarks. -RecordReplay=<name> records from the first loaded map on.
+ * -ReplayBenchmark=<name> plays the replay with a fixed step of
+ * 1/-ReplayBenchmarkFPS (30 by default) as fast as the machine allows,
+ * writes frame-time statistics to Saved/Profiling and exits.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UReplaySubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	FORCEINLINE bool IsRecording() const { return bRecording; }
+	FORCEINLINE bool IsBenchmarking() const { return !BenchmarkReplayName.IsEmpty(); }
+
+private:
+	void OnPostLoadMap(UWorld* World);
+
+	/** Log and save the frame-time statistics, then quit */
+	void FinishBenchmark();
+
+	FDelegateHandle PostLoadMapHandle;
+
+	FString RecordReplayName;
+	FString BenchmarkReplayName;
+
+	bool bRecording{ false };
+	bool bPlaybackRequested{ false };
+
+	/** Wall-clock frame times in milliseconds, one per played frame */
+	TArray<float> FrameTimes;
+	double LastFrameTime{ 0.0 };
+};
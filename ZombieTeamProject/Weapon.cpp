@@ -2,23 +2,25 @@
 
 
 #include "Weapon.h"
+#include "ZombieTeamProject.h"
+#include "Net/UnrealNetwork.h"
 
 AWeapon::AWeapon() : 
 	Ammo(30),
 	MagazineCapacity(30),
 	WeaponType(EWeaponType::EWT_AK47),
 	AmmoType(EAmmoType::EAT_9mm),
-	ReloadMontageSection(FName(TEXT("Reload AK47")))
+	ReloadMontageSection(FName(TEXT("Reload AK47"))),
+	PenetrationCount(0),
+	PenetrationDamageFalloff(0.25f)
 {
 
 }
 
-void AWeapon::Tick(float DeltaTime)
+void AWeapon::OnConstruction(const FTransform& Transform)
 {
-}
+	LLM_SCOPE_BYTAG(ZombieItems);
 
-//void AWeapon::OnConstruction(const FTransform& Transform)
-{
 	Super::OnConstruction(Transform);
 	const FString WeaponTablePath{ TEXT("DataTable'/Game/DataTable/WeaponDataTable.WeaponDataTable'") };
 	UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
@@ -47,6 +49,7 @@ void AWeapon::Tick(float DeltaTime)
 			SetWeaponIcon(WeaponDataRow->InventoryIcon);
 			SetWeaponAmmoIcon(WeaponDataRow->AmmoIcon);
 			SetReloadMontageSection(WeaponDataRow->ReloadMontageSection);
+			Crosshairs = WeaponDataRow->Crosshairs;
 			CrosshairsMiddle = WeaponDataRow->CrosshairsMiddle;
 			CrosshairsLeft = WeaponDataRow->CrosshairsLeft;
 			CrosshairsRight = WeaponDataRow->CrosshairsRight;
@@ -57,6 +60,8 @@ void AWeapon::Tick(float DeltaTime)
 			FireSound = WeaponDataRow->FireSound;
 			Damage = WeaponDataRow->Damage;
 			HeadShotDamage = WeaponDataRow->HeadShotDamage;
+			PenetrationCount = WeaponDataRow->PenetrationCount;
+			PenetrationDamageFalloff = WeaponDataRow->PenetrationDamageFalloff;
 		}
 	}
 }
@@ -73,12 +78,44 @@ void AWeapon::DecrementAmmo()
 	{
 		--Ammo;
 	}
+	OnAmmoChanged.Broadcast(Ammo, MagazineCapacity);
 }
 
 void AWeapon::ReloadAmmo(int32 Amount)
 {
 	checkf(Ammo + Amount <= MagazineCapacity, TEXT("Attempted to reload with more than magazine capacity"));
 	Ammo += Amount;
+	OnAmmoChanged.Broadcast(Ammo, MagazineCapacity);
+}
+
+UTexture2D* AWeapon::GetCrosshairPieceTexture(ECrosshairPiece Piece) const
+{
+	switch (Piece)
+	{
+	case ECrosshairPiece::ECP_Middle:
+		return CrosshairsMiddle;
+	case ECrosshairPiece::ECP_Left:
+		return CrosshairsLeft;
+	case ECrosshairPiece::ECP_Right:
+		return CrosshairsRight;
+	case ECrosshairPiece::ECP_Top:
+		return CrosshairsTop;
+	case ECrosshairPiece::ECP_Bottom:
+		return CrosshairsBottom;
+	default:
+		return nullptr;
+	}
 }
 
+void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Only the carrier's HUD shows the magazine
+	DOREPLIFETIME_CONDITION(AWeapon, Ammo, COND_ReplayOrOwner);
+}
 
+void AWeapon::OnRep_Ammo()
+{
+	OnAmmoChanged.Broadcast(Ammo, MagazineCapacity);
+}
@@ -7,8 +7,10 @@
 #include "AmmoType.h"
 #include "Engine/DataTable.h"
 #include "WeaponType.h"
+#include "CrosshairAtlas.h"
 #include "Weapon.generated.h"
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FWeaponAmmoChangedSignature, int32, Ammo, int32, MagazineCapacity);
 
 USTRUCT(BlueprintType)
 struct FWeaponDataTable : public FTableRowBase
@@ -42,6 +44,11 @@ struct FWeaponDataTable : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FName ReloadMontageSection;
 
+	/** Crosshair pieces packed into a single texture */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FCrosshairAtlas Crosshairs;
+
+	/** Separate crosshair textures, drawn while the row has no atlas */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	UTexture2D* CrosshairsMiddle;
 
@@ -71,6 +78,14 @@ struct FWeaponDataTable : public FTableRowBase
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float HeadShotDamage;
+
+	/** Number of extra enemies a bullet passes through after the first */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 PenetrationCount;
+
+	/** Fraction of damage lost for each enemy the bullet passes through */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float PenetrationDamageFalloff;
 };
 
 /**
@@ -83,13 +98,15 @@ class ZOMBIETEAMPROJECT_API AWeapon : public AItem
 public:
 	AWeapon();
 
-	virtual void Tick(float DeltaTime) override;
 protected:
 	
 	virtual void OnConstruction(const FTransform& Transform) override;
 
+	UFUNCTION()
+	void OnRep_Ammo();
+
 private:
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_Ammo, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	int32 Ammo;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
@@ -108,7 +125,11 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UDataTable* WeaponDataTable;
 
-	/** Textures for the weapon crosshairs */
+	/** Atlas with the weapon's crosshair pieces */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	FCrosshairAtlas Crosshairs;
+
+	/** Textures for the weapon crosshairs, used until the weapon has an atlas */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* CrosshairsMiddle;
 
@@ -142,7 +163,17 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	float HeadShotDamage;
 
+	/** Number of extra enemies a bullet passes through after the first */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	int32 PenetrationCount;
+
+	/** Fraction of damage lost for each enemy the bullet passes through */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	float PenetrationDamageFalloff;
+
 public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	FORCEINLINE int32 GetAmmo() const { return Ammo; }
 	FORCEINLINE int32 GetMagazineCapacity() const { return MagazineCapacity; }
 	void DecrementAmmo();
@@ -153,7 +184,17 @@ public:
 	FORCEINLINE void SetReloadMontageSection(FName Name) { ReloadMontageSection = Name; }
 	FORCEINLINE float GetDamage() const { return Damage; }
 	FORCEINLINE float GetHeadShotDamage() const { return HeadShotDamage; }
+	FORCEINLINE int32 GetPenetrationCount() const { return PenetrationCount; }
+	FORCEINLINE float GetPenetrationDamageFalloff() const { return PenetrationDamageFalloff; }
+	FORCEINLINE const FCrosshairAtlas& GetCrosshairs() const { return Crosshairs; }
+
+	/** Separate texture for a crosshair piece, for weapons without an atlas */
+	UTexture2D* GetCrosshairPieceTexture(ECrosshairPiece Piece) const;
 
 
 	void ReloadAmmo(int32 Amount);
+
+	/** Fired whenever the rounds in the magazine change */
+	UPROPERTY(BlueprintAssignable, Category = "Weapon Properties")
+	FWeaponAmmoChangedSignature OnAmmoChanged;
 };
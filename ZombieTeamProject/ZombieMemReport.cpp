@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ZombieTeamProject.h"
+#include "Enemy.h"
+#include "EnemyController.h"
+#include "Item.h"
+#include "Blueprint/UserWidget.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+	struct FMemReportCategory
+	{
+		const TCHAR* Name;
+		int32 Count{ 0 };
+		SIZE_T Bytes{ 0 };
+
+		void Add(SIZE_T InBytes)
+		{
+			++Count;
+			Bytes += InBytes;
+		}
+
+		void Print(FOutputDevice& Ar) const
+		{
+			const float AverageKB{ Count > 0 ? Bytes / 1024.f / Count : 0.f };
+			Ar.Logf(TEXT("  %-16s %6d  %10.1f KB  %8.2f KB avg"), Name, Count, Bytes / 1024.f, AverageKB);
+		}
+	};
+
+	/** Exclusive size of an actor plus every component it owns */
+	SIZE_T GetActorResourceSize(const AActor* Actor)
+	{
+		SIZE_T Bytes{ Actor->GetResourceSizeBytes(EResourceSizeMode::Exclusive) };
+		for (const UActorComponent* Component : Actor->GetComponents())
+		{
+			if (Component)
+			{
+				Bytes += Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			}
+		}
+		return Bytes;
+	}
+
+	void PrintMemReport(UWorld* World, FOutputDevice& Ar)
+	{
+		if (World == nullptr) return;
+
+		FMemReportCategory Enemies{ TEXT("Enemies") };
+		FMemReportCategory AI{ TEXT("AI") };
+		FMemReportCategory Items{ TEXT("Items") };
+		FMemReportCategory Widgets{ TEXT("Widgets") };
+		FMemReportCategory FX{ TEXT("FX") };
+
+		for (TActorIterator<AEnemy> It(World); It; ++It)
+		{
+			Enemies.Add(GetActorResourceSize(*It));
+		}
+		for (TActorIterator<AEnemyController> It(World); It; ++It)
+		{
+			AI.Add(GetActorResourceSize(*It));
+		}
+		for (TActorIterator<AItem> It(World); It; ++It)
+		{
+			Items.Add(GetActorResourceSize(*It));
+		}
+		for (TObjectIterator<UUserWidget> It; It; ++It)
+		{
+			if (It->GetWorld() == World)
+			{
+				Widgets.Add(It->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+			}
+		}
+		for (TObjectIterator<UParticleSystemComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World)
+			{
+				FX.Add(It->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+			}
+		}
+
+		Ar.Logf(TEXT("Zombie memory report (exclusive resource sizes)"));
+		Ar.Logf(TEXT("  %-16s %6s  %13s  %15s"), TEXT("Category"), TEXT("Count"), TEXT("Total"), TEXT("Per instance"));
+		Enemies.Print(Ar);
+		AI.Print(Ar);
+		Items.Print(Ar);
+		Widgets.Print(Ar);
+		FX.Print(Ar);
+
+		// Every live zombie carries its controller, blackboard and behavior tree instance
+		if (Enemies.Count > 0)
+		{
+			Ar.Logf(TEXT("  Per zombie incl. AI: %.2f KB"), (Enemies.Bytes + AI.Bytes) / 1024.f / Enemies.Count);
+		}
+		Ar.Logf(TEXT("  Run with -llm and use \"stat LLMFULL\" for the Zombie* allocation tags."));
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice ZombieMemReportCommand(
+	TEXT("zombie.MemReport"),
+	TEXT("Prints memory used by enemies, AI, items, widgets and particle effects, with per-instance averages."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+		{
+			PrintMemReport(World, Ar);
+		}));
@@ -0,0 +1,259 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ZombieReplicationGraph.h"
+#include "Enemy.h"
+#include "Item.h"
+#include "Weapon.h"
+#include "MainCharacter.h"
+#include "InventoryComponent.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+static TAutoConsoleVariable<int32> CVarZombieRepGraph(
+	TEXT("zombie.RepGraph"),
+	1,
+	TEXT("Use the zombie replication graph for game net drivers created from now on."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarZombieRepGraphCellSize(
+	TEXT("zombie.RepGraph.CellSize"),
+	10000.f,
+	TEXT("Size of the replication grid cells, in world units. Read when the graph is created."),
+	ECVF_Default);
+
+namespace
+{
+	/** Lowest corner the grid expects actors at; anything further out is clamped into the edge cells */
+	const FVector2D RepGraphSpatialBias{ -150000.f, -200000.f };
+}
+
+UZombieReplicationGraph::UZombieReplicationGraph() :
+	GridNode(nullptr),
+	AlwaysRelevantNode(nullptr)
+{
+}
+
+bool UZombieReplicationGraph::IsEnabled()
+{
+	return CVarZombieRepGraph.GetValueOnAnyThread() != 0;
+}
+
+void UZombieReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(AEnemy::StaticClass(), EClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(AItem::StaticClass(), EClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(AMainCharacter::StaticClass(), EClassRepNodeMapping::Spatialize_Dynamic);
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated()) continue;
+
+		// Skip blueprint compilation leftovers
+		const FString ClassName{ Class->GetName() };
+		if (ClassName.StartsWith(TEXT("SKEL_")) || ClassName.StartsWith(TEXT("REINST_"))) continue;
+
+		const EClassRepNodeMapping Mapping{ GetMappingPolicy(Class) };
+		const bool bSpatialize{ Mapping == EClassRepNodeMapping::Spatialize_Static
+			|| Mapping == EClassRepNodeMapping::Spatialize_Dynamic
+			|| Mapping == EClassRepNodeMapping::Spatialize_Dormancy };
+
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, bSpatialize);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+
+	ItemOwnerChangedHandle = UInventoryComponent::NotifyItemOwnerChanged.AddUObject(this, &UZombieReplicationGraph::OnItemOwnerChanged);
+	EquipWeaponHandle = AMainCharacter::NotifyEquipWeapon.AddUObject(this, &UZombieReplicationGraph::OnEquipWeapon);
+}
+
+EClassRepNodeMapping UZombieReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const EClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	// Anything not listed falls back on the actor's own relevancy settings
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+	EClassRepNodeMapping Mapping{ EClassRepNodeMapping::Spatialize_Dynamic };
+	if (ActorCDO->bOnlyRelevantToOwner)
+	{
+		Mapping = EClassRepNodeMapping::NotRouted;
+	}
+	else if (ActorCDO->bAlwaysRelevant || Class->IsChildOf(AInfo::StaticClass()))
+	{
+		Mapping = EClassRepNodeMapping::RelevantAllConnections;
+	}
+	else if (!ActorCDO->IsReplicatingMovement())
+	{
+		Mapping = EClassRepNodeMapping::Spatialize_Static;
+	}
+
+	ClassRepNodePolicies.Set(Class, Mapping);
+	return Mapping;
+}
+
+void UZombieReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const
+{
+	const AActor* ActorCDO = Class->GetDefaultObject<AActor>();
+	if (bSpatialize)
+	{
+		Info.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+	}
+	Info.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+}
+
+void UZombieReplicationGraph::InitGlobalGraphNodes()
+{
+	Super::InitGlobalGraphNodes();
+
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = CVarZombieRepGraphCellSize.GetValueOnGameThread();
+	GridNode->SpatialBias = RepGraphSpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UZombieReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	UZombieReplicationGraphNode_AlwaysRelevant_ForConnection* OwnerNode = CreateNewNode<UZombieReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(OwnerNode, RepGraphConnection);
+}
+
+void UZombieReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+void UZombieReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	// Held items already left the grid
+	if (HeldItems.Remove(ActorInfo.Actor) > 0) return;
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+void UZombieReplicationGraph::OnItemOwnerChanged(AItem* Item, AActor* NewOwner)
+{
+	if (Item == nullptr || Item->GetWorld() != GetWorld()) return;
+
+	const FNewReplicatedActorInfo ActorInfo(Item);
+	if (NewOwner)
+	{
+		bool bAlreadyHeld{ false };
+		HeldItems.Add(Item, &bAlreadyHeld);
+		if (!bAlreadyHeld)
+		{
+			GridNode->RemoveActor_Dormancy(ActorInfo);
+		}
+	}
+	else if (HeldItems.Remove(Item) > 0)
+	{
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalActorReplicationInfoMap.Get(Item));
+	}
+}
+
+void UZombieReplicationGraph::OnEquipWeapon(AMainCharacter* Character, AWeapon* PreviousWeapon, AWeapon* NewWeapon)
+{
+	if (Character == nullptr || Character->GetWorld() != GetWorld()) return;
+
+	if (PreviousWeapon)
+	{
+		GlobalActorReplicationInfoMap.RemoveDependentActor(Character, PreviousWeapon);
+	}
+	if (NewWeapon)
+	{
+		GlobalActorReplicationInfoMap.AddDependentActor(Character, NewWeapon);
+	}
+}
+
+void UZombieReplicationGraph::BeginDestroy()
+{
+	UInventoryComponent::NotifyItemOwnerChanged.Remove(ItemOwnerChangedHandle);
+	AMainCharacter::NotifyEquipWeapon.Remove(EquipWeaponHandle);
+
+	Super::BeginDestroy();
+}
+
+void UZombieReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	ReplicationActorList.Reset();
+
+	auto AddActor = [this](AActor* Actor)
+	{
+		if (Actor)
+		{
+			ReplicationActorList.ConditionalAdd(Actor);
+		}
+	};
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		AddActor(Viewer.InViewer);
+		AddActor(Viewer.ViewTarget);
+
+		const APlayerController* PlayerController = Cast<APlayerController>(Viewer.InViewer);
+		AMainCharacter* Character = PlayerController ? Cast<AMainCharacter>(PlayerController->GetPawn()) : nullptr;
+		if (Character == nullptr) continue;
+
+		AddActor(Character);
+
+		// Held items stay with their owner even when no other connection can see them
+		const UInventoryComponent* Inventory = Character->GetInventory();
+		for (int32 SlotIndex = 0; SlotIndex < UInventoryComponent::INVENTORY_CAPACITY; ++SlotIndex)
+		{
+			AddActor(Inventory->GetItemAt(SlotIndex));
+		}
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+}
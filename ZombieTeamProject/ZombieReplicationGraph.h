@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "ZombieReplicationGraph.generated.h"
+
+class AItem;
+class AWeapon;
+class AMainCharacter;
+
+/** How actors of a class are routed into the graph */
+enum class EClassRepNodeMapping : uint8
+{
+	NotRouted,				// Not in any global node; per-connection nodes or dependencies replicate it
+	RelevantAllConnections,	// Always relevant to every connection
+	Spatialize_Static,		// Placed in grid cells once and never moved
+	Spatialize_Dynamic,		// Re-bucketed into grid cells every frame
+	Spatialize_Dormancy,	// Static while dormant, dynamic while awake
+};
+
+/**
+ * Server replication graph. Enemies, loose pickups and other world actors are
+ * bucketed into a 2D grid, so each connection only gathers the cells around
+ * its view. Dormant pickups and idle enemies cost nothing until they wake.
+ * Items held in an inventory leave the grid: the owning connection gets them
+ * from its own node, and everyone else gets the equipped weapon as a
+ * dependent of the character holding it.
+ */
+UCLASS(Transient)
+class ZOMBIETEAMPROJECT_API UZombieReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UZombieReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual void BeginDestroy() override;
+
+	/** Whether new game net drivers should use this graph (zombie.RepGraph) */
+	static bool IsEnabled();
+
+private:
+	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const;
+
+	/** Move items between the grid and their holder as they enter and leave inventories */
+	void OnItemOwnerChanged(AItem* Item, AActor* NewOwner);
+
+	/** Keep the equipped weapon replicating wherever its character does */
+	void OnEquipWeapon(AMainCharacter* Character, AWeapon* PreviousWeapon, AWeapon* NewWeapon);
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
+
+	/** Items currently held in an inventory, and so out of the grid */
+	TSet<AActor*> HeldItems;
+
+	FDelegateHandle ItemOwnerChangedHandle;
+	FDelegateHandle EquipWeaponHandle;
+};
+
+/**
+ * Per-connection node: the connection's controller and view target, plus
+ * every item in its character's inventory, however far away they are.
+ */
+UCLASS()
+class ZOMBIETEAMPROJECT_API UZombieReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+};
@@ -12,8 +12,11 @@ public class ZombieTeamProject : ModuleRules
 
         PrivateDependencyModuleNames.AddRange(new string[] { });
 
-        // Uncomment if you are using Slate UI
-        // PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+        // Slate is used to paint the enemy health bar layer
+        PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+
+        // Server replication graph
+        PrivateDependencyModuleNames.AddRange(new string[] { "ReplicationGraph" });
 
         // Uncomment if you are using online features
         // PrivateDependencyModuleNames.Add("OnlineSubsystem");
@@ -2,6 +2,78 @@
 
 #include "ZombieTeamProject.h"
 #include "Modules/ModuleManager.h"
+#include "ZombieReplicationGraph.h"
+#include "Engine/NetDriver.h"
+#include "UObject/Package.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ZombieTeamProject, "ZombieTeamProject" );
+DEFINE_STAT(STAT_SendBullet);
+DEFINE_STAT(STAT_GetBeamEndLocation);
+DEFINE_STAT(STAT_ApplyBulletHits);
+DEFINE_STAT(STAT_TraceForItems);
+DEFINE_STAT(STAT_HitscanEnemyTrace);
+DEFINE_STAT(STAT_HitscanRewindTrace);
+DEFINE_STAT(STAT_UpdateHitNumbers);
+DEFINE_STAT(STAT_EnemyTakeDamage);
+DEFINE_STAT(STAT_EnemyBulletHit);
+DEFINE_STAT(STAT_EnemyOverlapEvents);
+DEFINE_STAT(STAT_ItemSetProperties);
+DEFINE_STAT(STAT_ItemInterp);
+DEFINE_STAT(STAT_ExplosiveRadialDamage);
+DEFINE_STAT(STAT_HealthBarPaint);
+
+DEFINE_STAT(STAT_ZombieTraces);
+DEFINE_STAT(STAT_ZombieOverlaps);
+DEFINE_STAT(STAT_ZombieFXSpawned);
+DEFINE_STAT(STAT_ZombieLiveEnemies);
+DEFINE_STAT(STAT_ZombieLiveHitNumbers);
+
+LLM_DEFINE_TAG(ZombieEnemies);
+LLM_DEFINE_TAG(ZombieAI);
+LLM_DEFINE_TAG(ZombieItems);
+LLM_DEFINE_TAG(ZombieFX);
+LLM_DEFINE_TAG(ZombieWidgets);
+
+bool ShouldPlayCosmetics(const UObject* WorldContextObject)
+{
+#if UE_SERVER
+	return false;
+#else
+	if (!FApp::CanEverRender()) return false;
+
+	// A dedicated server world can still share a rendering process in PIE
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World == nullptr || World->GetNetMode() != NM_DedicatedServer;
+#endif
+}
+
+/**
+ * Game module. Hands game net drivers the zombie replication graph; replay
+ * drivers keep the default relevancy so recordings capture every actor.
+ */
+class FZombieTeamProjectModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		UReplicationDriver::CreateReplicationDriverDelegate().BindLambda(
+			[](UNetDriver* ForNetDriver, const FURL& URL, UWorld* World) -> UReplicationDriver*
+			{
+				if (ForNetDriver == nullptr || ForNetDriver->NetDriverName != NAME_GameNetDriver || !UZombieReplicationGraph::IsEnabled())
+				{
+					return nullptr;
+				}
+				return NewObject<UZombieReplicationGraph>(GetTransientPackage());
+			});
+	}
+
+	virtual void ShutdownModule() override
+	{
+		UReplicationDriver::CreateReplicationDriverDelegate().Unbind();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FZombieTeamProjectModule, ZombieTeamProject, "ZombieTeamProject" );
  
\ No newline at end of file
@@ -1,5 +1,69 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
+ // Copyright Epic Games, Inc. All Rights Reserved.
 
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Project collision channels, configured in Project Settings > Collision
+ * (DefaultEngine.ini, [/Script/Engine.CollisionProfile]):
+ *
+ * Bullet        trace channel,  default response Block
+ * Interactable  trace channel,  default response Ignore
+ * EnemyHitbox   object channel, default response Ignore
+ */
+#define ECC_Bullet ECollisionChannel::ECC_GameTraceChannel1
+#define ECC_Interactable ECollisionChannel::ECC_GameTraceChannel2
+#define ECC_EnemyHitbox ECollisionChannel::ECC_GameTraceChannel3
+
+/**
+ * Gameplay stats, shown with "stat ZombieGame". Counters reset every frame;
+ * the live counts are accumulators that persist across frames.
+ */
+DECLARE_STATS_GROUP(TEXT("ZombieGame"), STATGROUP_ZombieGame, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Send Bullet"), STAT_SendBullet, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get Beam End Location"), STAT_GetBeamEndLocation, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Bullet Hits"), STAT_ApplyBulletHits, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trace For Items"), STAT_TraceForItems, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hitscan Enemy Trace"), STAT_HitscanEnemyTrace, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hitscan Rewind Trace"), STAT_HitscanRewindTrace, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Hit Numbers"), STAT_UpdateHitNumbers, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy Take Damage"), STAT_EnemyTakeDamage, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy Bullet Hit"), STAT_EnemyBulletHit, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enemy Overlap Events"), STAT_EnemyOverlapEvents, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Set Properties"), STAT_ItemSetProperties, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Item Interp"), STAT_ItemInterp, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Explosive Radial Damage"), STAT_ExplosiveRadialDamage, STATGROUP_ZombieGame, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Health Bar Paint"), STAT_HealthBarPaint, STATGROUP_ZombieGame, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces"), STAT_ZombieTraces, STATGROUP_ZombieGame, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlaps"), STAT_ZombieOverlaps, STATGROUP_ZombieGame, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("FX Spawned"), STAT_ZombieFXSpawned, STATGROUP_ZombieGame, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Enemies"), STAT_ZombieLiveEnemies, STATGROUP_ZombieGame, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Hit Numbers"), STAT_ZombieLiveHitNumbers, STATGROUP_ZombieGame, );
+
+/**
+ * Whether anyone sees or hears this world's cosmetics. False on dedicated
+ * servers and other processes that cannot render; sounds, particles,
+ * widgets and debug drawing are skipped there.
+ */
+ZOMBIETEAMPROJECT_API bool ShouldPlayCosmetics(const UObject* WorldContextObject);
+
+/** Cycle stat plus an Unreal Insights CPU scope with the same name */
+#define ZOMBIE_SCOPE_CYCLE_COUNTER(Stat) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat); \
+	SCOPE_CYCLE_COUNTER(Stat)
+
+/**
+ * Low-level memory tracker tags, reported by "stat LLMFULL" and -llmcsv when
+ * running with -llm. zombie.MemReport gives a live per-object breakdown.
+ */
+LLM_DECLARE_TAG_API(ZombieEnemies, ZOMBIETEAMPROJECT_API);
+LLM_DECLARE_TAG_API(ZombieAI, ZOMBIETEAMPROJECT_API);
+LLM_DECLARE_TAG_API(ZombieItems, ZOMBIETEAMPROJECT_API);
+LLM_DECLARE_TAG_API(ZombieFX, ZOMBIETEAMPROJECT_API);
+LLM_DECLARE_TAG_API(ZombieWidgets, ZOMBIETEAMPROJECT_API);
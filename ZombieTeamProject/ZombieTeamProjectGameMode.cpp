@@ -2,9 +2,14 @@
 
 #include "ZombieTeamProjectGameMode.h"
 #include "ZombieTeamProjectCharacter.h"
+#include "MainHUD.h"
+#include "BotPlayerController.h"
+#include "Misc/CommandLine.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Engine/World.h"
 
-AZombieTeamProjectGameMode::AZombieTeamProjectGameMode()
+AZombieTeamProjectGameMode::AZombieTeamProjectGameMode() :
+	GameplaySeed(1337)
 {
 	// set default pawn class to our Blueprinted character
 	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter"));
@@ -12,4 +17,40 @@ AZombieTeamProjectGameMode::AZombieTeamProjectGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	HUDClass = AMainHUD::StaticClass();
+	BotPlayerControllerClass = ABotPlayerController::StaticClass();
+}
+
+void AZombieTeamProjectGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	FParse::Value(FCommandLine::Get(), TEXT("GameplaySeed="), GameplaySeed);
+	SeedRandomStreams();
+
+	if (BotPlayerControllerClass && FParse::Param(FCommandLine::Get(), TEXT("BotPlayer")))
+	{
+		PlayerControllerClass = BotPlayerControllerClass;
+	}
+}
+
+void AZombieTeamProjectGameMode::SeedRandomStreams()
+{
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(RandomStreams); ++Index)
+	{
+		RandomStreams[Index].Initialize(static_cast<int32>(HashCombine(GetTypeHash(GameplaySeed), GetTypeHash(Index))));
+	}
+}
+
+FRandomStream& AZombieTeamProjectGameMode::GetRandomStream(const UObject* WorldContextObject, EGameplayRandomStream Stream)
+{
+	const UWorld* World{ WorldContextObject ? WorldContextObject->GetWorld() : nullptr };
+	if (AZombieTeamProjectGameMode* GameMode = World ? World->GetAuthGameMode<AZombieTeamProjectGameMode>() : nullptr)
+	{
+		return GameMode->RandomStreams[static_cast<uint8>(Stream)];
+	}
+
+	static FRandomStream FallbackStream{ 1337 };
+	return FallbackStream;
 }
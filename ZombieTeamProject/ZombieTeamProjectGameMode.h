@@ -6,6 +6,17 @@
 #include "GameFramework/GameModeBase.h"
 #include "ZombieTeamProjectGameMode.generated.h"
 
+/** Each system draws from its own stream so one system's rolls don't shift another's */
+UENUM(BlueprintType)
+enum class EGameplayRandomStream : uint8
+{
+	EGRS_Combat UMETA(DisplayName = "Combat"),
+	EGRS_AI UMETA(DisplayName = "AI"),
+	EGRS_Bot UMETA(DisplayName = "Bot"),
+
+	EGRS_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
 UCLASS(minimalapi)
 class AZombieTeamProjectGameMode : public AGameModeBase
 {
@@ -13,6 +24,30 @@ class AZombieTeamProjectGameMode : public AGameModeBase
 
 public:
 	AZombieTeamProjectGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	/**
+	 * Stream for gameplay randomness. Falls back to a fixed-seed stream when the
+	 * world has no AZombieTeamProjectGameMode, e.g. on clients.
+	 */
+	static FRandomStream& GetRandomStream(const UObject* WorldContextObject, EGameplayRandomStream Stream);
+
+	FORCEINLINE int32 GetGameplaySeed() const { return GameplaySeed; }
+
+protected:
+	/** Controller used instead of PlayerControllerClass when running with -BotPlayer */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Classes)
+	TSubclassOf<class ABotPlayerController> BotPlayerControllerClass;
+
+	/** Seed for all gameplay random streams, overridden by -GameplaySeed=<n> */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Random)
+	int32 GameplaySeed;
+
+private:
+	void SeedRandomStreams();
+
+	FRandomStream RandomStreams[static_cast<uint8>(EGameplayRandomStream::EGRS_MAX)];
 };
 
 